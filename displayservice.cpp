@@ -0,0 +1,159 @@
+/**
+ *  @filename   :   displayservice.cpp
+ *  @brief      :   Implements the display service
+ */
+
+#include "displayservice.h"
+
+#if MBED_CONF_RTOS_PRESENT
+
+// Event flags of the display thread
+#define DISPLAY_FLAG_FRAME 0x01
+#define DISPLAY_FLAG_STOP 0x02
+
+DisplayService::DisplayService(Epd &epd, osPriority priority, uint32_t stack_size) : m_epd(epd),
+                                                                                    m_thread(priority, stack_size),
+                                                                                    m_shown(0),
+                                                                                    m_failed(0),
+                                                                                    m_full_pending(false),
+                                                                                    m_started(false)
+{
+}
+
+/**
+ *  @brief: start the display thread, returns 0, or -1 if it could
+ *          not be started. a stopped service can't be started again.
+ */
+int DisplayService::Start(void)
+{
+    if (m_started)
+    {
+        return -1;
+    }
+    if (m_thread.start(callback(this, &DisplayService::Run)) != osOK)
+    {
+        return -1;
+    }
+    m_started = true;
+    return 0;
+}
+
+/**
+ *  @brief: end the display thread after the refresh it is in, frames
+ *          not shown yet are left
+ */
+void DisplayService::Stop(void)
+{
+    if (m_started)
+    {
+        m_flags.set(DISPLAY_FLAG_STOP);
+        m_thread.join();
+    }
+}
+
+/**
+ *  @brief: the buffer to draw the next frame into, see
+ *          FrameMailbox::GetBackBuffer. one producer thread only.
+ */
+unsigned char *DisplayService::GetBackBuffer(void)
+{
+    return m_mailbox.GetBackBuffer();
+}
+
+/**
+ *  @brief: show the back buffer, with a partial or a full refresh
+ */
+void DisplayService::Publish(bool partial)
+{
+    m_mailbox.Publish(partial);
+    m_flags.set(DISPLAY_FLAG_FRAME);
+}
+
+/**
+ *  @brief: show a copy of frame_buffer
+ */
+void DisplayService::Post(const unsigned char *frame_buffer, bool partial)
+{
+    m_mailbox.Post(frame_buffer, partial);
+    m_flags.set(DISPLAY_FLAG_FRAME);
+}
+
+/**
+ *  @brief: a frame is waiting for the display thread
+ */
+bool DisplayService::IsPending(void)
+{
+    return m_mailbox.HasFrame();
+}
+
+unsigned long DisplayService::GetShown(void)
+{
+    return m_shown;
+}
+
+/**
+ *  @brief: frames whose refresh returned an error
+ */
+unsigned long DisplayService::GetFailed(void)
+{
+    return m_failed;
+}
+
+unsigned long DisplayService::GetDropped(void)
+{
+    return m_mailbox.GetDropped();
+}
+
+/**
+ *  @brief: private function, the display thread. a full refresh
+ *          writes both RAM planes so partial ones can follow. after a
+ *          failed refresh the next frame is shown with a full one.
+ */
+void DisplayService::Run(void)
+{
+    for (;;)
+    {
+        uint32_t flags = m_flags.wait_any(DISPLAY_FLAG_FRAME | DISPLAY_FLAG_STOP);
+        if (flags & DISPLAY_FLAG_STOP)
+        {
+            return;
+        }
+
+        bool partial;
+        const unsigned char *frame_buffer;
+        while ((frame_buffer = m_mailbox.Take(&partial)) != NULL)
+        {
+            int result;
+            if (partial && !m_full_pending)
+            {
+                result = m_epd.DisplayPart(frame_buffer);
+            }
+            else
+            {
+                result = m_epd.DisplayPartBaseImage(frame_buffer);
+            }
+            if (result == EPD_RECOVERED)
+            {
+                /* the panel shows the recovery frame, not this one */
+                result = m_epd.DisplayPartBaseImage(frame_buffer);
+            }
+            m_full_pending = result != EPD_OK;
+            if (result == EPD_OK)
+            {
+                m_shown = m_shown + 1;
+            }
+            else
+            {
+                m_failed = m_failed + 1;
+            }
+            if (m_flags.get() & DISPLAY_FLAG_STOP)
+            {
+                return;
+            }
+        }
+    }
+}
+
+#endif /* MBED_CONF_RTOS_PRESENT */
+
+/* END OF FILE */
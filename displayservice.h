@@ -0,0 +1,62 @@
+/**
+ *  @filename   :   displayservice.h
+ *  @brief      :   Runs the panel I/O on a thread of its own. Other
+ *                  threads hand frames over through a FrameMailbox and
+ *                  go on at once, they never wait for SPI or BUSY.
+ *                  Only the newest frame is shown when they come
+ *                  faster than the panel refreshes. Needs the mbed
+ *                  RTOS. The Epd must be initialised and left to the
+ *                  service while it runs.
+ *
+ *                  The mailbox slot of a shown frame is drawn into
+ *                  again later, so the Epd's Recover needs a stable
+ *                  copy of it, see Epd::SetRecoveryFrame.
+ */
+
+#ifndef DISPLAYSERVICE_H
+#define DISPLAYSERVICE_H
+
+#include "framemailbox.h"
+
+#if MBED_CONF_RTOS_PRESENT
+
+// Default stack of the display thread
+#ifndef DISPLAY_SERVICE_STACK_SIZE
+#define DISPLAY_SERVICE_STACK_SIZE 1024
+#endif
+
+class DisplayService
+{
+public:
+    DisplayService(Epd &epd, osPriority priority = osPriorityBelowNormal,
+                   uint32_t stack_size = DISPLAY_SERVICE_STACK_SIZE);
+
+    int Start(void);
+    void Stop(void);
+
+    unsigned char *GetBackBuffer(void);
+    void Publish(bool partial);
+    void Post(const unsigned char *frame_buffer, bool partial);
+    bool IsPending(void);
+    unsigned long GetShown(void);
+    unsigned long GetFailed(void);
+    unsigned long GetDropped(void);
+
+private:
+    void Run(void);
+
+    Epd &m_epd;
+    FrameMailbox m_mailbox;
+    rtos::Thread m_thread;
+    rtos::EventFlags m_flags;
+    volatile unsigned long m_shown;
+    volatile unsigned long m_failed;
+    bool m_full_pending;
+    bool m_started;
+};
+
+#endif /* MBED_CONF_RTOS_PRESENT */
+
+#endif /* DISPLAYSERVICE_H */
+
+/* END OF FILE */
@@ -0,0 +1,207 @@
+/**
+ *  @filename   :   dither.cpp
+ *  @brief      :   Implements the grayscale to 1-bit conversion
+ */
+
+#include <string.h>
+#include "dither.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * 8x8 Bayer matrix as thresholds: a pixel is white if its gray value is
+ * at least the threshold, so 0 is always black and 255 always white.
+ */
+static const uint8_t bayer_threshold[8][8] = {
+    {3, 131, 35, 163, 11, 139, 43, 171},
+    {195, 67, 227, 99, 203, 75, 235, 107},
+    {51, 179, 19, 147, 59, 187, 27, 155},
+    {243, 115, 211, 83, 251, 123, 219, 91},
+    {15, 143, 47, 175, 7, 135, 39, 167},
+    {207, 79, 239, 111, 199, 71, 231, 103},
+    {63, 191, 31, 159, 55, 183, 23, 151},
+    {255, 127, 223, 95, 247, 119, 215, 87},
+};
+
+/**
+ *  @brief: sink writing the output rows into a frame buffer
+ *          described by a DitherFrameBuffer
+ */
+void DitherToFrameBuffer(void *context, int y, const unsigned char *row, int width)
+{
+    DitherFrameBuffer *target = (DitherFrameBuffer *)context;
+
+    memcpy(&target->frame_buffer[(target->y + y) * target->stride + target->x / 8], row, (width + 7) / 8);
+}
+
+GrayDither::GrayDither(int source_width,
+                       int source_height,
+                       int width,
+                       int height,
+                       int method,
+                       DitherSink sink,
+                       void *context) : m_source_width(source_width),
+                                        m_source_height(source_height),
+                                        m_width(width),
+                                        m_height(height),
+                                        m_method(method),
+                                        m_sink(sink),
+                                        m_context(context)
+{
+    Reset();
+}
+
+/**
+ *  @brief: false if the sizes are not supported
+ */
+bool GrayDither::IsValid(void)
+{
+    return m_source_width > 0 && m_source_height > 0 &&
+           m_width > 0 && m_width <= DITHER_MAX_WIDTH && m_height > 0 &&
+           m_sink != NULL;
+}
+
+/**
+ *  @brief: start over with the first source row
+ */
+void GrayDither::Reset(void)
+{
+    m_source_row = 0;
+    m_row = 0;
+    memset(m_gray, 0, sizeof(m_gray));
+    memset(m_error, 0, sizeof(m_error));
+}
+
+/**
+ *  @brief: feed the next source row of source_width gray values.
+ *          returns the number of output rows it produced, which may be
+ *          0 when scaling down or several when scaling up.
+ */
+int GrayDither::PushRow(const uint8_t *gray)
+{
+    int produced = 0;
+
+    if (!IsValid() || m_source_row >= m_source_height)
+    {
+        return 0;
+    }
+    while (m_row < m_height &&
+           (long)m_row * m_source_height / m_height == m_source_row)
+    {
+        if (produced == 0)
+        {
+            Scale(gray);
+        }
+        if (m_method == DITHER_FLOYD_STEINBERG)
+        {
+            FloydSteinberg();
+        }
+        else
+        {
+            Bayer(m_row);
+        }
+        m_sink(m_context, m_row, m_bits, m_width);
+        m_row++;
+        produced++;
+    }
+    m_source_row++;
+    return produced;
+}
+
+/**
+ *  @brief: private function to sample a source row to the output width
+ */
+void GrayDither::Scale(const uint8_t *gray)
+{
+    if (m_source_width == m_width)
+    {
+        memcpy(m_gray, gray, m_width);
+        return;
+    }
+    for (int x = 0; x < m_width; x++)
+    {
+        m_gray[x] = gray[(long)x * m_source_width / m_width];
+    }
+}
+
+/* reverse the bit order of a byte */
+static inline unsigned char Reverse(unsigned char b)
+{
+    b = (b >> 4) | (b << 4);
+    b = ((b >> 2) & 0x33) | ((b & 0x33) << 2);
+    return ((b >> 1) & 0x55) | ((b & 0x55) << 1);
+}
+
+/**
+ *  @brief: private function to threshold the scaled row against
+ *          row y of the Bayer matrix, 16 pixels per step with SSE2
+ */
+void GrayDither::Bayer(int y)
+{
+    const uint8_t *t = bayer_threshold[y % 8];
+    int x = 0;
+
+#if defined(__SSE2__)
+    uint8_t row[16];
+    memcpy(row, t, 8);
+    memcpy(row + 8, t, 8);
+    __m128i threshold = _mm_loadu_si128((const __m128i *)row);
+    for (; x + 16 <= m_width; x += 16)
+    {
+        __m128i g = _mm_loadu_si128((const __m128i *)&m_gray[x]);
+        /* g >= threshold, unsigned */
+        __m128i white = _mm_cmpeq_epi8(_mm_max_epu8(g, threshold), g);
+        int bits = _mm_movemask_epi8(white);
+        m_bits[x / 8] = Reverse(bits & 0xFF);
+        m_bits[x / 8 + 1] = Reverse(bits >> 8);
+    }
+#endif
+
+    /* the remaining pixels one at a time */
+    for (; x < m_width; x += 8)
+    {
+        unsigned char out = 0;
+        for (int k = 0; k < 8; k++)
+        {
+            if (x + k < m_width && m_gray[x + k] >= t[k])
+            {
+                out |= 0x80 >> k;
+            }
+        }
+        m_bits[x / 8] = out;
+    }
+}
+
+/**
+ *  @brief: private function to quantize the scaled row, spreading the
+ *          error to the right and to the next row (7, 3, 5, 1 / 16)
+ */
+void GrayDither::FloydSteinberg(void)
+{
+    int16_t *error = m_error[m_row % 2] + 1;
+    int16_t *next = m_error[(m_row + 1) % 2] + 1;
+
+    memset(m_bits, 0, (m_width + 7) / 8);
+    memset(next - 1, 0, (m_width + 2) * sizeof(int16_t));
+    for (int x = 0; x < m_width; x++)
+    {
+        int value = m_gray[x] + error[x];
+        int e;
+
+        if (value >= 128)
+        {
+            m_bits[x / 8] |= 0x80 >> (x % 8);
+            e = value - 255;
+        }
+        else
+        {
+            e = value;
+        }
+        error[x + 1] += e * 7 / 16;
+        next[x - 1] += e * 3 / 16;
+        next[x] += e * 5 / 16;
+        next[x + 1] += e / 16;
+    }
+}
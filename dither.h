@@ -0,0 +1,80 @@
+/**
+ *  @filename   :   dither.h
+ *  @brief      :   Converts 8-bit grayscale images to the 1-bit frame
+ *                  buffer format (1 is white, msb first), one source row
+ *                  at a time, so images can be streamed from wherever
+ *                  they come from without holding them in memory.
+ *
+ *                  The image is scaled to the output size by sampling the
+ *                  nearest source pixel, then dithered with an 8x8 Bayer
+ *                  matrix (vectorized on SSE2 hosts) or with
+ *                  Floyd-Steinberg error diffusion. Every finished output
+ *                  row is handed to a sink, e.g. DitherToFrameBuffer.
+ */
+
+#ifndef DITHER_H
+#define DITHER_H
+
+#include <stdint.h>
+
+#define DITHER_BAYER 0
+#define DITHER_FLOYD_STEINBERG 1
+
+// Widest output row, the display width by default
+#ifndef DITHER_MAX_WIDTH
+#define DITHER_MAX_WIDTH 200
+#endif
+
+typedef void (*DitherSink)(void *context, int y, const unsigned char *row, int width);
+
+/* sink context to write the output into a frame buffer */
+struct DitherFrameBuffer
+{
+    unsigned char *frame_buffer;
+    int stride; /* bytes per frame buffer row */
+    int x;      /* multiple of 8 */
+    int y;
+};
+
+void DitherToFrameBuffer(void *context, int y, const unsigned char *row, int width);
+
+class GrayDither
+{
+public:
+    GrayDither(int source_width,
+               int source_height,
+               int width,
+               int height,
+               int method,
+               DitherSink sink,
+               void *context);
+
+    bool IsValid(void);
+    int PushRow(const uint8_t *gray);
+    void Reset(void);
+
+private:
+    void Scale(const uint8_t *gray);
+    void Bayer(int y);
+    void FloydSteinberg(void);
+
+    int m_source_width;
+    int m_source_height;
+    int m_width;
+    int m_height;
+    int m_method;
+    DitherSink m_sink;
+    void *m_context;
+    int m_source_row;
+    int m_row;
+    /* scaled row, padded for the 16 pixel vector loop */
+    uint8_t m_gray[DITHER_MAX_WIDTH + 16];
+    /* Floyd-Steinberg error of this and the next row, one pixel of
+       margin each side */
+    int16_t m_error[2][DITHER_MAX_WIDTH + 2];
+    unsigned char m_bits[(DITHER_MAX_WIDTH + 15) / 8];
+};
+
+#endif /* DITHER_H */
+
+/* END OF FILE */
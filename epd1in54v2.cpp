@@ -25,8 +25,128 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "epd1in54v2.h"
 
+/* each font bit nibble widened 2x, 3x and 4x for DrawScaledCharAt */
+static const unsigned short scale_nibble[MAX_TEXT_SCALE - 1][16] = {
+    {0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF},
+    {0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF, 0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF},
+    {0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF, 0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF},
+};
+
+/*
+ * 4x4 Bayer ordered dither for DrawGrayCharAt. for 2 bit coverage the
+ * pixels lit at levels 1 and 2 per matrix row, 8 columns msb first.
+ * for 4 bit coverage the matrix itself, scaled so level 15 is solid.
+ */
+static const unsigned char dither_level1[4] = {0xAA, 0x44, 0xAA, 0x11};
+static const unsigned char dither_level2[4] = {0xFF, 0x55, 0xBB, 0x55};
+static const unsigned char dither_threshold[4][4] = {
+    {0, 7, 1, 9},
+    {11, 3, 13, 5},
+    {2, 10, 0, 8},
+    {14, 6, 12, 4},
+};
+
+/*
+ * typical SSD1681 1.54" figures at 3.3 V: 3 mA while refreshing, 1 mA
+ * for resets and waveform loads, 30 uA idle with the analog block off,
+ * 1 uA in deep sleep, SPI at 2 MHz about 4 nC a byte
+ */
+const EpdPowerModel epd_default_power_model = {3000, 1000, 30, 1, 4, 1000};
+
+/* display modes for UpdateSequence, the OTP holds a waveform for each */
+#define UPDATE_MODE_1 1
+#define UPDATE_MODE_2 2
+
+/* private BlendSpan modes next to the BITMAP_ ones, painting the set bits */
+#define BLEND_PAINT_COLORED 5
+#define BLEND_PAINT_UNCOLORED 6
+
+/*
+ * waveforms for SetLut, LUT0..LUT3 are picked by the old (0x26) and new
+ * (0x24) pixel. lut_full_update is the panel's OTP full refresh.
+ * lut_partial_update only drives the pixels that change, one phase of
+ * 15 frames and one of 1, which completes in about 300 ms.
+ */
+const unsigned char lut_full_update[EPD_LUT_SIZE] = {
+    0x80, 0x48, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x48, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x48, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x48, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x01, 0x00, 0x08, 0x01, 0x00, 0x02,
+    0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00,
+    0x22, 0x17, 0x41, 0x00, 0x32, 0x20,
+};
+
+const unsigned char lut_partial_update[EPD_LUT_SIZE] = {
+    0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00,
+    0x02, 0x17, 0x41, 0xB0, 0x32, 0x28,
+};
+
+/*
+ * 4 gray levels for DisplayGray. the level's high bit is in the 0x26
+ * plane and its low bit in the 0x24 plane, which selects LUT0 (black)
+ * to LUT3 (white). VSH1 drives black, VSL white. every pixel is shaken
+ * and driven white first, then the darker levels get 3, 8 and 20
+ * frames of black. tuned at room temperature.
+ */
+const unsigned char lut_4gray[EPD_LUT_SIZE] = {
+    /* VS per group, LUT0..LUT4 (LUT4 is VCOM) */
+    0x60, 0x80, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x60, 0x80, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x60, 0x80, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x60, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* TP A, TP B, SR AB, TP C, TP D, SR CD, RP per group */
+    0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x05, 0x00, 0x0C, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* frame rate, gate scan selection */
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00,
+    /* EOPT, VGH, VSH1, VSH2, VSL, VCOM */
+    0x22, 0x17, 0x41, 0x00, 0x32, 0x20,
+};
+
 Epd::~Epd(){};
 
 Epd::Epd(PinName mosi,
@@ -37,10 +157,56 @@ Epd::Epd(PinName mosi,
          PinName rst,
          PinName busy) : EpdIf(mosi, miso, sclk, cs, dc, rst, busy) //
 {
+    SetDefaults();
+}
+
+/**
+ *  @brief: a panel on a shared SPI bus, see EpdIf
+ */
+Epd::Epd(SPI *spi,
+         PinName cs,
+         PinName dc,
+         PinName rst,
+         PinName busy,
+         int frequency) : EpdIf(spi, cs, dc, rst, busy, frequency)
+{
+    SetDefaults();
+}
 
+/**
+ *  @brief: private function for the state both constructors set
+ */
+void Epd::SetDefaults(void)
+{
     width = EPD_WIDTH;
     height = EPD_HEIGHT;
     rotate = ROTATE_0;
+    text_cache = NULL;
+    ram_y_reversed = false;
+    current_lut = NULL;
+    temperature_interval = EPD_TEMPERATURE_INTERVAL;
+    analog_hold = false;
+    external_temperature = false;
+    temperature_celsius = 0;
+    lut_bands = NULL;
+    lut_band_count = 0;
+    partial_options = false;
+    sleeping = false;
+    reset_pulse = EPD_RESET_PULSE_MS;
+    reset_settle = EPD_RESET_SETTLE_MS;
+    busy_timeout = EPD_BUSY_TIMEOUT;
+    refresh_timeout = EPD_REFRESH_TIMEOUT;
+    auto_recover = false;
+    recovering = false;
+    last_frame = NULL;
+    recovery_frame = NULL;
+    last_command = 0;
+    refreshing = false;
+    refresh_started_ms = 0;
+    power_model = epd_default_power_model;
+    ResetEnergyStats();
+    ResetErrorStats();
+    ForgetUpdateState();
 }
 
 /**
@@ -50,6 +216,8 @@ void Epd::SendCommand(unsigned char command) //
 {
     DigitalWrite(m_dc, LOW);
     SpiTransfer(command);
+    last_command = command;
+    energy.bytes_sent++;
 }
 
 /**
@@ -59,19 +227,73 @@ void Epd::SendData(unsigned char data) //
 {
     DigitalWrite(m_dc, HIGH);
     SpiTransfer(data);
+    CountData(1);
+}
+
+/**
+ *  @brief: send a block of data in one SPI burst
+ */
+void Epd::SendData(const unsigned char *data, int length) //
+{
+    DigitalWrite(m_dc, HIGH);
+    SpiTransfer(data, length);
+    CountData(length);
+}
+
+/**
+ *  @brief: private function to send length times the same data byte
+ */
+void Epd::SendFill(unsigned char data, int length)
+{
+    unsigned char chunk[EPD_WIDTH / 8];
+
+    memset(chunk, data, sizeof(chunk));
+    while (length > 0)
+    {
+        int n = length < (int)sizeof(chunk) ? length : sizeof(chunk);
+        SendData(chunk, n);
+        length -= n;
+    }
+}
+
+/**
+ *  @brief: Wait until the m_busy goes LOW. returns EPD_OK, or
+ *          EPD_ERROR_BUSY_TIMEOUT if it is still high after the
+ *          busy timeout.
+ */
+int Epd::WaitUntilIdle(void) //
+{
+    unsigned long waited;
+    int result = WaitBusy(busy_timeout, &waited);
+
+    energy.busy_ms += waited;
+    if (result != EPD_OK)
+    {
+        errors.busy_timeouts++;
+        errors.last_error = result;
+    }
+    return result;
 }
 
 /**
- *  @brief: Wait until the m_busy goes HIGH
+ *  @brief: private function to poll BUSY for up to timeout ms
  */
-void Epd::WaitUntilIdle(void) //
+int Epd::WaitBusy(unsigned long timeout, unsigned long *waited)
 {
-    int cnt{0};
-    while (DigitalRead(m_busy) == 1 && ++cnt<3)
-    { //0: busy, 1: idle
-        DelayMs(100);
+    unsigned long start = GetMs();
+    int result = EPD_OK;
+
+    while (DigitalRead(m_busy) == 1)
+    { //1: busy, 0: idle
+        if (GetMs() - start >= timeout)
+        {
+            result = EPD_ERROR_BUSY_TIMEOUT;
+            break;
+        }
+        DelayMs(1);
     }
-    DelayMs(200);
+    *waited = GetMs() - start;
+    return result;
 }
 
 // int Epd::Init(const unsigned char *lut)
@@ -85,52 +307,30 @@ int Epd::HDirInit(void) //
     /* this calls the peripheral hardware interface, see epdif */
     if (IfInit() != 0)
     {
-        return -1;
+        return EPD_ERROR_INTERFACE;
     }
     /* EPD hardware init start */
     Reset();
-
-    WaitUntilIdle();
+    ram_y_reversed = true;
+    current_lut = NULL;
+    partial_options = false;
+    refreshing = false;
+    EndSleep();
+    energy.inits++;
+    ForgetUpdateState();
+
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
     SendCommand(0x12); //SWRESET
-    WaitUntilIdle();
-
-    SendCommand(0x01); //Driver output control
-    SendData(0xC7);
-    SendData(0x00);
-    SendData(0x01);
-
-    SendCommand(0x11); //data entry mode
-    SendData(0x01);
-
-    SendCommand(0x44); //set Ram-X address start/end position
-    SendData(0x00);
-    SendData(0x18); //0x0C-->(18+1)*8=200
-
-    SendCommand(0x45); //set Ram-Y address start/end position
-    SendData(0xC7);    //0xC7-->(199+1)=200
-    SendData(0x00);
-    SendData(0x00);
-    SendData(0x00);
-
-    SendCommand(0x3C); //BorderWavefrom
-    SendData(0x01);
-
-    SendCommand(0x18);
-    SendData(0x80);
-
-    SendCommand(0x22); // //Load Temperature and waveform setting.
-    SendData(0XB1);
-    SendCommand(0x20);
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
 
-    SendCommand(0x4E); // set RAM x address count to 0;
-    SendData(0x00);
-    SendCommand(0x4F); // set RAM y address count to 0X199;
-    SendData(0xC7);
-    SendData(0x00);
-    WaitUntilIdle();
     /* EPD hardware init end */
-
-    return 0;
+    return SendConfig();
 }
 
 int Epd::LDirInit(void) //
@@ -138,32 +338,70 @@ int Epd::LDirInit(void) //
     /* this calls the peripheral hardware interface, see epdif */
     if (IfInit() != 0)
     {
-        return -1;
+        return EPD_ERROR_INTERFACE;
     }
     /* EPD hardware init start */
     Reset();
-
-    WaitUntilIdle();
+    ram_y_reversed = false;
+    current_lut = NULL;
+    partial_options = false;
+    refreshing = false;
+    EndSleep();
+    energy.inits++;
+    ForgetUpdateState();
+
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
     SendCommand(0x12); //SWRESET
-    WaitUntilIdle();
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
+
+    /* EPD hardware init end */
+    return SendConfig();
+}
 
+/**
+ *  @brief: private function to write the registers of the init
+ *          function picked by ram_y_reversed, after a reset
+ */
+int Epd::SendConfig(void)
+{
     SendCommand(0x01); //Driver output control
     SendData(0xC7);
     SendData(0x00);
-    SendData(0x00);
+    SendData(ram_y_reversed ? 0x01 : 0x00);
 
     SendCommand(0x11); //data entry mode
-    SendData(0x03);
+    SendData(ram_y_reversed ? 0x01 : 0x03);
 
-    SendCommand(0x44);
-    /* x point must be the multiple of 8 or the last 3 bits will be ignored */
-    SendData((0 >> 3) & 0xFF);
-    SendData((200 >> 3) & 0xFF);
-    SendCommand(0x45);
-    SendData(0 & 0xFF);
-    SendData((0 >> 8) & 0xFF);
-    SendData(200 & 0xFF);
-    SendData((200 >> 8) & 0xFF);
+    if (ram_y_reversed)
+    {
+        SendCommand(0x44); //set Ram-X address start/end position
+        SendData(0x00);
+        SendData(0x18); //0x0C-->(18+1)*8=200
+
+        SendCommand(0x45); //set Ram-Y address start/end position
+        SendData(0xC7);    //0xC7-->(199+1)=200
+        SendData(0x00);
+        SendData(0x00);
+        SendData(0x00);
+    }
+    else
+    {
+        SendCommand(0x44);
+        /* x point must be the multiple of 8 or the last 3 bits will be ignored */
+        SendData((0 >> 3) & 0xFF);
+        SendData((200 >> 3) & 0xFF);
+        SendCommand(0x45);
+        SendData(0 & 0xFF);
+        SendData((0 >> 8) & 0xFF);
+        SendData(200 & 0xFF);
+        SendData((200 >> 8) & 0xFF);
+    }
 
     SendCommand(0x3C); //BorderWavefrom
     SendData(0x01);
@@ -174,16 +412,66 @@ int Epd::LDirInit(void) //
     SendCommand(0x22); // //Load Temperature and waveform setting.
     SendData(0XB1);
     SendCommand(0x20);
+    temperature_loaded = true;
+    temperature_ms = GetMs();
+    otp_lut_mode = UPDATE_MODE_1;
 
     SendCommand(0x4E); // set RAM x address count to 0;
     SendData(0x00);
     SendCommand(0x4F); // set RAM y address count to 0X199;
     SendData(0xC7);
     SendData(0x00);
-    WaitUntilIdle();
-    /* EPD hardware init end */
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
+    if (external_temperature)
+    {
+        /* the reset went back to the internal sensor reading */
+        SendTemperature();
+    }
+    return EPD_OK;
+}
+
+/**
+ *  @brief: leave deep sleep without a full init. a reset pulse
+ *          wakes the controller, then only the registers are written
+ *          again: the init function's configuration and the waveform
+ *          and partial options that were loaded. after SLEEP_MODE_1
+ *          the display RAM still holds the last frame, so partial
+ *          refreshes go on against it; after SLEEP_MODE_2 upload a
+ *          whole frame first, e.g. with DisplayPartBaseImage.
+ */
+int Epd::Wake(void)
+{
+    if (!sleeping)
+    {
+        return EPD_OK;
+    }
+    const unsigned char *lut = current_lut;
+    bool partial = partial_options;
+
+    Reset();
+    EndSleep();
+    energy.wakes++;
+    current_lut = NULL;
+    refreshing = false;
+    ForgetUpdateState();
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
 
-    return 0;
+    int result = SendConfig();
+    if (result == EPD_OK && lut != NULL)
+    {
+        result = SetLut(lut);
+    }
+    if (result == EPD_OK && partial)
+    {
+        result = SendPartialOptions();
+    }
+    return result;
 }
 
 /**
@@ -193,153 +481,418 @@ int Epd::LDirInit(void) //
  */
 void Epd::Reset(void) //
 {
-    DigitalWrite(m_rst, HIGH);
-    DelayMs(200);
+    energy.resets++;
+    energy.last_reset_ms = GetMs();
     DigitalWrite(m_rst, LOW); //module reset
-    DelayMs(10);
+    DelayMs(reset_pulse);
     DigitalWrite(m_rst, HIGH);
-    DelayMs(200);
+    DelayMs(reset_settle);
+    /* the caller waits for BUSY */
 }
 
-void Epd::ClearDisplay(void) //
+/**
+ *  @brief: reset pulse and the time after it before BUSY is read, in
+ *          ms. the defaults are the datasheet minimum, longer ones
+ *          help with slow supply ramps.
+ */
+void Epd::SetResetTiming(unsigned int pulse_ms, unsigned int settle_ms)
+{
+    reset_pulse = pulse_ms;
+    reset_settle = settle_ms;
+}
+
+/**
+ *  @brief: longest wait for BUSY in ms after a reset or a command
+ *          other than a refresh, so a missing panel doesn't hang the
+ *          caller. these take tens of ms, see SetRefreshTimeout.
+ */
+void Epd::SetBusyTimeout(unsigned long timeout_ms)
+{
+    busy_timeout = timeout_ms;
+}
+
+/**
+ *  @brief: longest refresh in ms before FinishRefresh gives up with
+ *          EPD_ERROR_REFRESH_TIMEOUT. refreshes get slower in the cold.
+ */
+void Epd::SetRefreshTimeout(unsigned long timeout_ms)
+{
+    refresh_timeout = timeout_ms;
+}
+
+/**
+ *  @brief: let the display functions call Recover when a refresh
+ *          times out, and return its result
+ */
+void Epd::SetAutoRecover(bool enable)
+{
+    auto_recover = enable;
+}
+
+/**
+ *  @brief: a frame buffer the owner keeps equal to what the panel
+ *          shows, for Recover to put back instead of the last one
+ *          uploaded. NULL goes back to the last one uploaded.
+ */
+void Epd::SetRecoveryFrame(const unsigned char *frame_buffer)
+{
+    recovery_frame = frame_buffer;
+}
+
+/**
+ *  @brief: hardware reset and init again with the last init
+ *          direction, put the last whole frame uploaded back to both
+ *          RAM planes with a full refresh, then load the waveform and
+ *          partial options that were in use again. only the pointer
+ *          of that frame is kept: if the buffer has been drawn into
+ *          since, as the back buffer of FrameBuffers or a mailbox
+ *          slot, give a stable one with SetRecoveryFrame. without
+ *          either, after ClearDisplay or DisplayGray, the panel is
+ *          only initialised.
+ *          returns EPD_OK or the error of the step that failed.
+ */
+int Epd::Recover(void)
+{
+    const unsigned char *frame_buffer = recovery_frame != NULL ? recovery_frame : last_frame;
+    const unsigned char *lut = current_lut;
+    bool partial = partial_options;
+
+    recovering = true;
+    int result = ram_y_reversed ? HDirInit() : LDirInit();
+    if (result == EPD_OK && frame_buffer != NULL)
+    {
+        /* on the OTP waveform, as after RefreshPolicy's base image */
+        UploadBaseImage(frame_buffer);
+        result = DisplayFrame();
+    }
+    if (result == EPD_OK && lut != NULL)
+    {
+        result = SetLut(lut);
+    }
+    if (result == EPD_OK && partial)
+    {
+        result = SendPartialOptions();
+    }
+    recovering = false;
+
+    if (result == EPD_OK)
+    {
+        errors.recoveries++;
+    }
+    else
+    {
+        errors.failed_recoveries++;
+        errors.last_error = result;
+    }
+    return result;
+}
+
+/**
+ *  @brief: timeouts and recoveries since the last ResetErrorStats
+ */
+const EpdErrorStats &Epd::GetErrorStats(void)
+{
+    return errors;
+}
+
+void Epd::ResetErrorStats(void)
+{
+    memset(&errors, 0, sizeof(errors));
+}
+
+int Epd::ClearDisplay(void) //
 {
     int w, h;
     w = (EPD_WIDTH % 8 == 0) ? (EPD_WIDTH / 8) : (EPD_WIDTH / 8 + 1);
     h = EPD_HEIGHT;
 
+    BeginTransaction();
     SendCommand(0x24);
-    for (int j = 0; j < h; j++)
-    {
-        for (int i = 0; i < w; i++)
-        {
-            SendData(0xff);
-        }
-    }
+    SendFill(0xff, w * h);
+    EndTransaction();
+    last_frame = NULL;
+    //DISPLAY REFRESH
+    return DisplayFrame();
+}
+
+int Epd::Display(const unsigned char *frame_buffer) //
+{
+    UploadFrame(frame_buffer);
+
+    //DISPLAY REFRESH
+    return DisplayFrame();
+}
+
+int Epd::DisplayPartBaseImage(const unsigned char *frame_buffer) //
+{
+    UploadBaseImage(frame_buffer);
+
     //DISPLAY REFRESH
-    DisplayFrame();
+    return DisplayFrame();
 }
 
-void Epd::Display(const unsigned char *frame_buffer) //
+/**
+ *  @brief: put a whole frame buffer to the display RAM, the 0x24
+ *          plane only. this won't update the display.
+ */
+void Epd::UploadFrame(const unsigned char *frame_buffer)
 {
     int w = (EPD_WIDTH % 8 == 0) ? (EPD_WIDTH / 8) : (EPD_WIDTH / 8 + 1);
     int h = EPD_HEIGHT;
 
     if (frame_buffer != NULL)
     {
+        BeginTransaction();
         SendCommand(0x24);
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                SendData(frame_buffer[i + j * w]);
-            }
-        }
+        SendData(frame_buffer, w * h);
+        EndTransaction();
+        last_frame = frame_buffer;
     }
-
-    //DISPLAY REFRESH
-    DisplayFrame();
 }
 
-void Epd::DisplayPartBaseImage(const unsigned char *frame_buffer) //
+/**
+ *  @brief: put a whole frame buffer to both RAM planes, as the base
+ *          partial refreshes compare with. this won't update the display.
+ */
+void Epd::UploadBaseImage(const unsigned char *frame_buffer)
 {
     int w = (EPD_WIDTH % 8 == 0) ? (EPD_WIDTH / 8) : (EPD_WIDTH / 8 + 1);
     int h = EPD_HEIGHT;
 
     if (frame_buffer != NULL)
     {
+        BeginTransaction();
         SendCommand(0x24);
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                SendData(frame_buffer[i + j * w]);
-            }
-        }
+        SendData(frame_buffer, w * h);
 
         SendCommand(0x26);
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                SendData(frame_buffer[i + j * w]);
-            }
-        }
+        SendData(frame_buffer, w * h);
+        EndTransaction();
+        last_frame = frame_buffer;
     }
-
-    //DISPLAY REFRESH
-    DisplayFrame();
 }
-void Epd::DisplayPartBaseWhiteImage(void) //
+int Epd::DisplayPartBaseWhiteImage(void) //
 {
     int w = (EPD_WIDTH % 8 == 0) ? (EPD_WIDTH / 8) : (EPD_WIDTH / 8 + 1);
     int h = EPD_HEIGHT;
 
+    BeginTransaction();
     SendCommand(0x24);
-    for (int j = 0; j < h; j++)
-    {
-        for (int i = 0; i < w; i++)
-        {
-            SendData(0xff);
-        }
-    }
+    SendFill(0xff, w * h);
 
     SendCommand(0x26);
-    for (int j = 0; j < h; j++)
-    {
-        for (int i = 0; i < w; i++)
-        {
-            SendData(0xff);
-        }
-    }
+    SendFill(0xff, w * h);
+    EndTransaction();
+    last_frame = NULL;
 
     //DISPLAY REFRESH
-    DisplayFrame();
+    return DisplayFrame();
 }
 
-void Epd::DisplayPart(const unsigned char *frame_buffer) //
+int Epd::DisplayPart(const unsigned char *frame_buffer) //
 {
-    int w = (EPD_WIDTH % 8 == 0) ? (EPD_WIDTH / 8) : (EPD_WIDTH / 8 + 1);
-    int h = EPD_HEIGHT;
+    UploadFrame(frame_buffer);
 
-    if (frame_buffer != NULL)
+    //DISPLAY REFRESH
+    return DisplayPartFrame();
+}
+
+/**
+ *  @brief: partial refresh after uploading only the rows and byte
+ *          columns of the frame buffer under x, y, w, h, given in the
+ *          rotated coordinates of the drawing functions. the rest of
+ *          the display RAM must still hold the frame buffer.
+ */
+int Epd::DisplayPartArea(const unsigned char *frame_buffer, int x, int y, int w, int h)
+{
+    int px, py, pw, ph;
+
+    if (frame_buffer == NULL || !MapRect(x, y, w, h, &px, &py, &pw, &ph))
     {
-        SendCommand(0x24);
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                SendData(frame_buffer[i + j * w]);
-            }
-        }
+        return EPD_OK;
+    }
+    int x_start = px / 8 * 8;
+    int x_end = (px + pw - 1) | 7;
+    int row_bytes = (x_end - x_start + 1) / 8;
+
+    BeginTransaction();
+    SetRamWindow(x_start, x_end, py, py + ph - 1);
+    SendCommand(WRITE_RAM);
+    for (int j = py; j < py + ph; j++)
+    {
+        SendData(&frame_buffer[j * (EPD_WIDTH / 8) + x_start / 8], row_bytes);
     }
+    SetRamWindow(0, EPD_WIDTH - 1, 0, EPD_HEIGHT - 1);
+    EndTransaction();
+    last_frame = frame_buffer;
 
     //DISPLAY REFRESH
-    DisplayPartFrame();
+    return DisplayPartFrame();
 }
 
 /**
- *  @brief: set the look-up table register
+ *  @brief: set the look-up table register and the voltages that
+ *          come with it, see lut_4gray for the EPD_LUT_SIZE bytes.
+ *          refreshes must then use 0xC7 so the OTP waveform isn't
+ *          loaded over it.
  */
-// void Epd::SetLut(const unsigned char *lut)
-// {
-//     SendCommand(WRITE_LUT_REGISTER);
-//     /* the length of look-up table is 30 bytes */
-//     for (int i = 0; i < 30; i++)
-//     {
-//         SendData(lut[i]);
-//     }
-// }
+int Epd::SetLut(const unsigned char *lut)
+{
+    SendCommand(WRITE_LUT_REGISTER);
+    SendData(lut, 153);
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
+    BeginTransaction();
+
+    SendCommand(0x3F); //end option
+    SendData(lut[153]);
+    SendCommand(0x03); //gate voltage
+    SendData(lut[154]);
+    SendCommand(0x04); //source voltage
+    SendData(lut[155]); //VSH1
+    SendData(lut[156]); //VSH2
+    SendData(lut[157]); //VSL
+    SendCommand(WRITE_VCOM_REGISTER);
+    SendData(lut[158]);
+    EndTransaction();
+    current_lut = lut;
+    otp_lut_mode = 0;
+    return EPD_OK;
+}
 
 /**
- *  @brief: put an image buffer to the frame memory.
- *          this won't update the display.
+ *  @brief: switch to the fast partial waveform. call after one of the
+ *          init functions and DisplayPartBaseImage, then update with
+ *          DisplayPart. a full init goes back to the OTP waveforms.
  */
-void Epd::SetFrameMemory(
-    const unsigned char *image_buffer,
-    int x,
-    int y,
-    int image_width,
-    int image_height) //
+int Epd::PartInit(void)
+{
+    int result = SetLut(lut_partial_update);
+    if (result != EPD_OK)
+    {
+        return result;
+    }
+    return SendPartialOptions();
+}
+
+/**
+ *  @brief: private function for the register settings of PartInit
+ */
+int Epd::SendPartialOptions(void)
+{
+    SendCommand(0x37); //display option, ping-pong for mode 2
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x40);
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x00);
+    SendData(0x00);
+
+    SendCommand(BORDER_WAVEFORM_CONTROL);
+    SendData(0x80); //border follows VCOM
+
+    SendCommand(DISPLAY_UPDATE_CONTROL_2);
+    SendData(0xC0); //clock and analog on
+    SendCommand(MASTER_ACTIVATION);
+    if (WaitUntilIdle() != EPD_OK)
+    {
+        return EPD_ERROR_BUSY_TIMEOUT;
+    }
+    analog_on = true;
+    partial_options = true;
+    return EPD_OK;
+}
+
+/**
+ *  @brief: init for the 4 gray level mode, see DisplayGray
+ */
+int Epd::GrayInit(void)
+{
+    int result = HDirInit();
+    if (result != EPD_OK)
+    {
+        return result;
+    }
+    return SetLut(lut_4gray);
+}
+
+/* gather the even bits of a word, msb first, into 16 bits */
+static inline unsigned long EvenBits(unsigned long w)
+{
+    w &= 0x55555555UL;
+    w = (w | (w >> 1)) & 0x33333333UL;
+    w = (w | (w >> 2)) & 0x0F0F0F0FUL;
+    w = (w | (w >> 4)) & 0x00FF00FFUL;
+    return (w | (w >> 8)) & 0x0000FFFFUL;
+}
+
+/**
+ *  @brief: private function to send one bit plane of a gray buffer,
+ *          16 pixels per 32 bit word
+ */
+void Epd::SendGrayPlane(const unsigned char *gray_buffer, int shift)
+{
+    unsigned char chunk[EPD_WIDTH / 4];
+    int n = 0;
+
+    for (int i = 0; i < EPD_GRAY_BUFFER_SIZE; i += 4)
+    {
+        unsigned long w = (unsigned long)gray_buffer[i] << 24 | (unsigned long)gray_buffer[i + 1] << 16 |
+                          (unsigned long)gray_buffer[i + 2] << 8 | gray_buffer[i + 3];
+        unsigned long bits = EvenBits(w >> shift);
+
+        chunk[n++] = bits >> 8;
+        chunk[n++] = bits;
+        if (n == sizeof(chunk))
+        {
+            SendData(chunk, n);
+            n = 0;
+        }
+    }
+    if (n > 0)
+    {
+        SendData(chunk, n);
+    }
+}
+
+/**
+ *  @brief: show a 2 bit per pixel gray buffer, after GrayInit.
+ *          the low bits go to the 0x24 plane, the high bits to 0x26.
+ */
+int Epd::DisplayGray(const unsigned char *gray_buffer)
+{
+    if (sleeping)
+    {
+        return EPD_ERROR_SLEEPING;
+    }
+    BeginTransaction();
+    SendCommand(0x24);
+    SendGrayPlane(gray_buffer, 0);
+    SendCommand(0x26);
+    SendGrayPlane(gray_buffer, 1);
+    EndTransaction();
+    last_frame = NULL;
+
+    Activate(UPDATE_MODE_1);
+    return AutoRecover(FinishRefresh());
+}
+
+/**
+ *  @brief: put an image buffer to the frame memory.
+ *          this won't update the display.
+ */
+void Epd::SetFrameMemory(
+    const unsigned char *image_buffer,
+    int x,
+    int y,
+    int image_width,
+    int image_height) //
 {
     int x_end;
     int y_end;
@@ -379,6 +932,7 @@ void Epd::SetFrameMemory(
     }
     SetMemoryArea(x, y, x_end, y_end);
     SetMemoryPointer(x, y);
+    BeginTransaction();
     SendCommand(WRITE_RAM);
     /* send the image data */
     for (int j = 0; j < y_end - y + 1; j++)
@@ -388,6 +942,61 @@ void Epd::SetFrameMemory(
             SendData(image_buffer[i + j * (image_width / 8)]);
         }
     }
+    EndTransaction();
+}
+
+/**
+ *  @brief: put a packed image (see imagepack.h) to the frame memory,
+ *          unpacking it row by row straight into the display RAM.
+ *          like SetFrameMemory, x and the width are truncated to
+ *          multiples of 8. this won't update the display.
+ */
+void Epd::SetFrameMemoryPacked(const unsigned char *packed_image, int x, int y) //
+{
+    if (packed_image == NULL || x < 0 || y < 0)
+    {
+        return;
+    }
+    ImageUnpacker image(packed_image);
+    int image_width = image.GetWidth() & 0xF8;
+    int x_end;
+    int y_end;
+
+    if (!image.IsValid() || image_width == 0)
+    {
+        return;
+    }
+    x &= 0xF8;
+    if (x + image_width >= (int)this->width)
+    {
+        x_end = this->width - 1;
+    }
+    else
+    {
+        x_end = x + image_width - 1;
+    }
+    if (y + image.GetHeight() >= (int)this->height)
+    {
+        y_end = this->height - 1;
+    }
+    else
+    {
+        y_end = y + image.GetHeight() - 1;
+    }
+    if (x_end < x || y_end < y)
+    {
+        return;
+    }
+    SetMemoryArea(x, y, x_end, y_end);
+    SetMemoryPointer(x, y);
+    BeginTransaction();
+    SendCommand(WRITE_RAM);
+    /* unpack and send the visible rows */
+    for (int j = 0; j < y_end - y + 1; j++)
+    {
+        SendData(image.ReadRow(), (x_end - x + 1) / 8);
+    }
+    EndTransaction();
 }
 
 /**
@@ -413,22 +1022,375 @@ void Epd::SetFrameMemory(
  *          the the next action of SetFrameMemory or ClearFrame will 
  *          set the other memory area.
  */
-void Epd::DisplayFrame(void) //
+int Epd::DisplayFrame(void) //
 {
-    SendCommand(DISPLAY_UPDATE_CONTROL_2);
-    // SendData(0xC4);
-    SendData(0xF7);
-    SendCommand(MASTER_ACTIVATION);
-    // SendCommand(TERMINATE_FRAME_READ_WRITE);
-    WaitUntilIdle();
+    int result = StartRefresh(false);
+    if (result == EPD_OK)
+    {
+        result = FinishRefresh();
+    }
+    return AutoRecover(result);
+}
+
+int Epd::DisplayPartFrame(void) //
+{
+    int result = StartRefresh(true);
+    if (result == EPD_OK)
+    {
+        result = FinishRefresh();
+    }
+    return AutoRecover(result);
+}
+
+/**
+ *  @brief: start a full or partial refresh of the display RAM and
+ *          return while it runs. the panel takes no other commands
+ *          until IsBusy is false, call FinishRefresh before the next
+ *          one. lets several panels refresh at the same time.
+ */
+int Epd::StartRefresh(bool partial)
+{
+    int mode = partial ? UPDATE_MODE_2 : UPDATE_MODE_1;
+
+    if (sleeping)
+    {
+        /* the controller ignores all but a reset */
+        return EPD_ERROR_SLEEPING;
+    }
+
+    if (lut_bands != NULL && external_temperature)
+    {
+        int result = SelectBandLut(mode);
+        if (result != EPD_OK)
+        {
+            return result;
+        }
+    }
+    else if (!partial && current_lut != NULL && current_lut != lut_full_update)
+    {
+        /* back to the OTP waveform */
+        current_lut = NULL;
+    }
+    /* mode 2 with the loaded waveform after PartInit, else from OTP */
+    Activate(mode);
+    return EPD_OK;
+}
+
+bool Epd::IsBusy(void)
+{
+    return DigitalRead(m_busy) == 1;
+}
+
+/**
+ *  @brief: StartRefresh ran and FinishRefresh didn't yet
+ */
+bool Epd::IsRefreshing(void)
+{
+    return refreshing;
+}
+
+/**
+ *  @brief: the refresh in progress is past the refresh timeout,
+ *          counted from its start. FinishRefresh then returns at once.
+ */
+bool Epd::RefreshTimedOut(void)
+{
+    return refreshing && GetMs() - refresh_started_ms >= refresh_timeout;
+}
+
+/**
+ *  @brief: wait for the refresh StartRefresh began. returns EPD_OK,
+ *          or EPD_ERROR_REFRESH_TIMEOUT if BUSY is still high after
+ *          the refresh timeout, counted from the start.
+ */
+int Epd::FinishRefresh(void)
+{
+    if (!refreshing)
+    {
+        return EPD_OK;
+    }
+    unsigned long elapsed = GetMs() - refresh_started_ms;
+    unsigned long waited;
+    int result = WaitBusy(elapsed < refresh_timeout ? refresh_timeout - elapsed : 0, &waited);
+
+    refreshing = false;
+    energy.refresh_ms += GetMs() - refresh_started_ms;
+    energy.last_refresh_ms = GetMs();
+    if (result != EPD_OK)
+    {
+        result = EPD_ERROR_REFRESH_TIMEOUT;
+        errors.refresh_timeouts++;
+        errors.last_error = result;
+    }
+    return result;
+}
+
+/**
+ *  @brief: call Recover if result is a refresh timeout and
+ *          SetAutoRecover enabled it, else return result. for callers
+ *          that finish refreshes themselves, like DisplayFrame does.
+ *          returns EPD_RECOVERED after a good recovery: the panel shows
+ *          the recovery frame, not the one that was asked for.
+ */
+int Epd::AutoRecover(int result)
+{
+    if (result != EPD_ERROR_REFRESH_TIMEOUT || !auto_recover || recovering)
+    {
+        return result;
+    }
+    result = Recover();
+    return result == EPD_OK ? EPD_RECOVERED : result;
 }
 
-void Epd::DisplayPartFrame(void) //
+/**
+ *  @brief: private function to run the update sequence for mode
+ */
+void Epd::Activate(int mode)
 {
     SendCommand(DISPLAY_UPDATE_CONTROL_2);
-    SendData(0xFF);
+    SendData(UpdateSequence(mode));
     SendCommand(MASTER_ACTIVATION);
-    WaitUntilIdle();
+    if (mode == UPDATE_MODE_2)
+    {
+        energy.partial_refreshes++;
+    }
+    else
+    {
+        energy.full_refreshes++;
+    }
+    refreshing = true;
+    refresh_started_ms = GetMs();
+}
+
+/**
+ *  @brief: the currents and charges GetChargeMah works with
+ */
+void Epd::SetPowerModel(const EpdPowerModel &model)
+{
+    power_model = model;
+}
+
+/**
+ *  @brief: counters and times since the last ResetEnergyStats
+ */
+const EpdEnergyStats &Epd::GetEnergyStats(void)
+{
+    if (sleeping)
+    {
+        /* count the sleep so far */
+        unsigned long now = GetMs();
+        energy.sleep_ms += now - energy.sleep_since_ms;
+        energy.sleep_since_ms = now;
+    }
+    return energy;
+}
+
+void Epd::ResetEnergyStats(void)
+{
+    memset(&energy, 0, sizeof(energy));
+    energy.start_ms = GetMs();
+    energy.sleep_since_ms = energy.start_ms;
+}
+
+/**
+ *  @brief: estimated charge drawn by the panel since the last
+ *          ResetEnergyStats, from the counters and the power model
+ */
+float Epd::GetChargeMah(void)
+{
+    const EpdEnergyStats &stats = GetEnergyStats();
+    unsigned long elapsed = GetMs() - stats.start_ms;
+    unsigned long accounted = stats.busy_ms + stats.refresh_ms + stats.sleep_ms;
+    unsigned long idle_ms = elapsed > accounted ? elapsed - accounted : 0;
+
+    /* uA * ms and nC both in nC */
+    unsigned long long nc = (unsigned long long)stats.busy_ms * power_model.busy_ua +
+                            (unsigned long long)stats.refresh_ms * power_model.refresh_ua +
+                            (unsigned long long)stats.sleep_ms * power_model.sleep_ua +
+                            (unsigned long long)idle_ms * power_model.idle_ua +
+                            (unsigned long long)stats.bytes_sent * power_model.byte_nc +
+                            (unsigned long long)stats.resets * power_model.reset_nc;
+    /* 1 mAh is 3.6 C */
+    return nc / 3.6e9f;
+}
+
+/**
+ *  @brief: private function to count data bytes, and the ones that
+ *          went to the display RAM
+ */
+void Epd::CountData(int length)
+{
+    energy.bytes_sent += length;
+    if (last_command == WRITE_RAM || last_command == 0x26)
+    {
+        energy.ram_bytes += length;
+    }
+}
+
+/**
+ *  @brief: private function to end the sleep time, on wake or init
+ */
+void Epd::EndSleep(void)
+{
+    if (sleeping)
+    {
+        energy.sleep_ms += GetMs() - energy.sleep_since_ms;
+        sleeping = false;
+    }
+}
+
+/**
+ *  @brief: how often a refresh reloads the temperature, and with it
+ *          the OTP waveform, in ms. 0 reloads it on every refresh.
+ */
+void Epd::SetTemperatureInterval(unsigned long interval_ms)
+{
+    temperature_interval = interval_ms;
+}
+
+/**
+ *  @brief: use a temperature measured elsewhere instead of the slow
+ *          internal sensor. the controller then picks its OTP waveform
+ *          for this temperature, or the band from SetLutBands applies.
+ *          call again when the temperature changes.
+ */
+void Epd::SetTemperature(int celsius)
+{
+    external_temperature = true;
+    temperature_celsius = celsius;
+    SendTemperature();
+}
+
+/**
+ *  @brief: go back to reading the internal sensor on refresh
+ */
+void Epd::UseInternalTemperature(void)
+{
+    external_temperature = false;
+    temperature_loaded = false;
+}
+
+/**
+ *  @brief: waveforms by temperature band, sorted by min_celsius, for
+ *          use with SetTemperature. the first band also covers
+ *          anything colder. NULL goes back to the OTP waveforms.
+ */
+void Epd::SetLutBands(const EpdLutBand *bands, int count)
+{
+    lut_bands = count > 0 ? bands : NULL;
+    lut_band_count = count;
+}
+
+/**
+ *  @brief: private function to write the external temperature to the
+ *          sensor register, 1/16 degrees in 12 bits
+ */
+void Epd::SendTemperature(void)
+{
+    int value = temperature_celsius * 16;
+
+    SendCommand(TEMPERATURE_SENSOR_CONTROL);
+    SendData((value >> 4) & 0xFF);
+    SendData((value << 4) & 0xF0);
+    temperature_loaded = true;
+    /* the OTP waveform for the old temperature is loaded */
+    otp_lut_mode = 0;
+}
+
+/**
+ *  @brief: private function to load the waveform of the current
+ *          temperature band for a refresh in mode, unless it already
+ *          is. a band without one for the mode uses the OTP waveform.
+ *          a partial one comes with PartInit's register settings.
+ */
+int Epd::SelectBandLut(int mode)
+{
+    int band = 0;
+
+    while (band + 1 < lut_band_count && lut_bands[band + 1].min_celsius <= temperature_celsius)
+    {
+        band++;
+    }
+    const unsigned char *lut = mode == UPDATE_MODE_2 ? lut_bands[band].lut_partial : lut_bands[band].lut_full;
+    if (lut == NULL)
+    {
+        current_lut = NULL;
+        return EPD_OK;
+    }
+    int result = EPD_OK;
+    if (lut != current_lut)
+    {
+        result = SetLut(lut);
+    }
+    if (result == EPD_OK && mode == UPDATE_MODE_2 && !partial_options)
+    {
+        result = SendPartialOptions();
+    }
+    return result;
+}
+
+/**
+ *  @brief: keep the clock and analog block on after a refresh, so
+ *          back to back refreshes skip powering them up again. costs
+ *          current while idle, Sleep turns them off.
+ */
+void Epd::SetAnalogHold(bool hold)
+{
+    analog_hold = hold;
+}
+
+/**
+ *  @brief: private function to pick the DISPLAY_UPDATE_CONTROL_2 steps
+ *          a refresh in mode needs, skipping what is already loaded
+ *          or powered. updates the state as if the refresh ran.
+ */
+unsigned char Epd::UpdateSequence(int mode)
+{
+    unsigned char sequence = 0x04; //display
+
+    if (mode == UPDATE_MODE_2)
+    {
+        sequence |= 0x08;
+    }
+    if (!analog_on)
+    {
+        sequence |= 0xC0; //enable clock and analog
+    }
+    if (current_lut == NULL)
+    {
+        /* the OTP waveform depends on the temperature */
+        if (!temperature_loaded ||
+            (!external_temperature && GetMs() - temperature_ms >= temperature_interval))
+        {
+            sequence |= 0x20;
+            temperature_loaded = true;
+            temperature_ms = GetMs();
+            otp_lut_mode = 0;
+        }
+        if (otp_lut_mode != mode)
+        {
+            sequence |= 0x10;
+            otp_lut_mode = mode;
+        }
+    }
+    if (!analog_hold)
+    {
+        sequence |= 0x03; //disable analog and clock
+    }
+    analog_on = analog_hold;
+    return sequence;
+}
+
+/**
+ *  @brief: private function to forget what the controller has loaded,
+ *          after a reset
+ */
+void Epd::ForgetUpdateState(void)
+{
+    analog_on = false;
+    temperature_loaded = false;
+    temperature_ms = 0;
+    otp_lut_mode = 0;
 }
 
 /**
@@ -461,97 +1423,416 @@ void Epd::SetMemoryPointer(int x, int y) //
     WaitUntilIdle();
 }
 
+/**
+ *  @brief: private function to open a RAM window for frame buffer
+ *          columns x_start..x_end (multiples of 8 apart) and rows
+ *          first_row..last_row, written in that order, whichever
+ *          direction the init function chose for the RAM.
+ *          unlike SetMemoryPointer this doesn't wait for the display.
+ */
+void Epd::SetRamWindow(int x_start, int x_end, int first_row, int last_row)
+{
+    int ram_first = ram_y_reversed ? EPD_HEIGHT - 1 - first_row : first_row;
+    int ram_last = ram_y_reversed ? EPD_HEIGHT - 1 - last_row : last_row;
+
+    SendCommand(DATA_ENTRY_MODE_SETTING);
+    /* x increment, y increment or decrement */
+    SendData(ram_last >= ram_first ? 0x03 : 0x01);
+    SendCommand(SET_RAM_X_ADDRESS_START_END_POSITION);
+    SendData((x_start >> 3) & 0xFF);
+    SendData((x_end >> 3) & 0xFF);
+    SendCommand(SET_RAM_Y_ADDRESS_START_END_POSITION);
+    SendData(ram_first & 0xFF);
+    SendData((ram_first >> 8) & 0xFF);
+    SendData(ram_last & 0xFF);
+    SendData((ram_last >> 8) & 0xFF);
+    SendCommand(SET_RAM_X_ADDRESS_COUNTER);
+    SendData((x_start >> 3) & 0xFF);
+    SendCommand(SET_RAM_Y_ADDRESS_COUNTER);
+    SendData(ram_first & 0xFF);
+    SendData((ram_first >> 8) & 0xFF);
+}
+
 /**
  *  @brief: After this command is transmitted, the chip would enter the 
  *          deep-sleep mode to save power. 
  *          The deep sleep mode would return to standby by hardware reset. 
- *          You can use Epd::Init() to awaken
+ *          You can use Epd::Wake() or Epd::Init() to awaken
+ */
+int Epd::Sleep() //
+{
+    return Sleep(SLEEP_MODE_1);
+}
+
+/**
+ *  @brief: deep sleep in SLEEP_MODE_1, which keeps the display RAM,
+ *          or SLEEP_MODE_2, which draws less but loses it
  */
-void Epd::Sleep() //
+int Epd::Sleep(int mode)
 {
+    /* a refresh StartRefresh left running ends first */
+    int result = FinishRefresh();
     SendCommand(DEEP_SLEEP_MODE);
-    SendData(0x01);
-    WaitUntilIdle();
+    SendData(mode == SLEEP_MODE_2 ? SLEEP_MODE_2 : SLEEP_MODE_1);
+    /* no wait on BUSY, the controller keeps it high while asleep */
+    analog_on = false;
+    sleeping = true;
+    energy.sleep_since_ms = GetMs();
+
+    DigitalWrite(m_rst, LOW);
+    return result;
+}
+
+/////////PAINT////////////
+
+/**
+ *  @brief: clear the image
+ */
+void Epd::ClearFramebuffer(unsigned char *frame_buffer, int colored)//
+{
+    for (int x = 0; x < this->width; x++)
+    {
+        for (int y = 0; y < this->height; y++)
+        {
+            SetAbsolutePixel(frame_buffer, x, y, colored);
+        }
+    }
+}
+
+/**
+ *  @brief: fill a gray buffer with one of GRAY_BLACK..GRAY_WHITE
+ */
+void Epd::ClearGrayFramebuffer(unsigned char *gray_buffer, int level)
+{
+    memset(gray_buffer, (level & 3) * 0x55, EPD_GRAY_BUFFER_SIZE);
+}
+
+/**
+ *  @brief: set a pixel of a gray buffer, rotated like SetPixel
+ */
+void Epd::SetGrayPixel(unsigned char *gray_buffer, int x, int y, int level)
+{
+    if (x < 0 || x >= (int)width || y < 0 || y >= (int)height)
+    {
+        return;
+    }
+    MapPoint(x, y, &x, &y);
+    if (x < 0 || x >= EPD_WIDTH || y < 0 || y >= EPD_HEIGHT)
+    {
+        return;
+    }
+    int shift = 6 - 2 * (x % 4);
+    unsigned char *p = &gray_buffer[(x + y * EPD_WIDTH) / 4];
+    *p = (*p & ~(3 << shift)) | (level & 3) << shift;
+}
+
+/**
+ *  @brief: private function to read a pixel of a gray buffer, rotated
+ *          like SetGrayPixel. -1 outside the panel.
+ */
+int Epd::GetGrayPixel(const unsigned char *gray_buffer, int x, int y)
+{
+    if (x < 0 || x >= (int)width || y < 0 || y >= (int)height)
+    {
+        return -1;
+    }
+    MapPoint(x, y, &x, &y);
+    if (x < 0 || x >= EPD_WIDTH || y < 0 || y >= EPD_HEIGHT)
+    {
+        return -1;
+    }
+    return (gray_buffer[(x + y * EPD_WIDTH) / 4] >> (6 - 2 * (x % 4))) & 3;
+}
+
+/**
+ *  @brief: draw an 8 bit grayscale image (0 is black) into a gray
+ *          buffer, ordered dithered between the 4 levels
+ */
+void Epd::DrawGrayImage(unsigned char *gray_buffer, const unsigned char *image, int x, int y, int image_width, int image_height)
+{
+    for (int j = 0; j < image_height; j++)
+    {
+        const unsigned char *t = dither_threshold[(((y + j) % 4) + 4) % 4];
+        for (int i = 0; i < image_width; i++)
+        {
+            /* 3 levels of 255 steps, plus a threshold of 16ths */
+            int level = (image[j * image_width + i] * 48 + t[(((x + i) % 4) + 4) % 4] * 255) / (255 * 16);
+            SetGrayPixel(gray_buffer, x + i, y + j, level > 3 ? 3 : level);
+        }
+    }
+}
+
+void Epd::SetRotate(int rotate)
+{
+    if (rotate == ROTATE_0)
+    {
+        this->rotate = ROTATE_0;
+        width = EPD_WIDTH;
+        height = EPD_HEIGHT;
+    }
+    else if (rotate == ROTATE_90)
+    {
+        this->rotate = ROTATE_90;
+        width = EPD_HEIGHT;
+        height = EPD_WIDTH;
+    }
+    else if (rotate == ROTATE_180)
+    {
+        this->rotate = ROTATE_180;
+        width = EPD_WIDTH;
+        height = EPD_HEIGHT;
+    }
+    else if (rotate == ROTATE_270)
+    {
+        this->rotate = ROTATE_270;
+        width = EPD_HEIGHT;
+        height = EPD_WIDTH;
+    }
+}
+
+void Epd::SetPixel(unsigned char *frame_buffer, int x, int y, int colored)//
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+    {
+        return;
+    }
+    MapPoint(x, y, &x, &y);
+    SetAbsolutePixel(frame_buffer, x, y, colored);
+}
+
+/**
+ *  @brief: private function to translate a rotated point
+ *          to frame buffer coordinates
+ */
+void Epd::MapPoint(int x, int y, int *px, int *py)
+{
+    if (rotate == ROTATE_90)
+    {
+        *px = EPD_WIDTH - 1 - y;
+        *py = x;
+    }
+    else if (rotate == ROTATE_180)
+    {
+        *px = EPD_WIDTH - 1 - x;
+        *py = EPD_HEIGHT - 1 - y;
+    }
+    else if (rotate == ROTATE_270)
+    {
+        *px = y;
+        *py = EPD_HEIGHT - 1 - x;
+    }
+    else
+    {
+        *px = x;
+        *py = y;
+    }
+}
+
+/**
+ *  @brief: private function to translate a rotated rectangle
+ *          to frame buffer coordinates, clipped to the display.
+ *          returns false if nothing of it is visible.
+ */
+bool Epd::MapRect(int x, int y, int w, int h, int *px, int *py, int *pw, int *ph)
+{
+    int x0, y0, x1, y1;
+
+    /* clip in rotated coordinates first, like SetPixel does */
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > (int)width)
+    {
+        w = width - x;
+    }
+    if (y + h > (int)height)
+    {
+        h = height - y;
+    }
+    if (w <= 0 || h <= 0)
+    {
+        return false;
+    }
+
+    MapPoint(x, y, &x0, &y0);
+    MapPoint(x + w - 1, y + h - 1, &x1, &y1);
+    if (x0 > x1)
+    {
+        int temp = x0;
+        x0 = x1;
+        x1 = temp;
+    }
+    if (y0 > y1)
+    {
+        int temp = y0;
+        y0 = y1;
+        y1 = temp;
+    }
+
+    /* then to the frame buffer, like SetAbsolutePixel does */
+    if (x0 < 0)
+    {
+        x0 = 0;
+    }
+    if (y0 < 0)
+    {
+        y0 = 0;
+    }
+    if (x1 >= EPD_WIDTH)
+    {
+        x1 = EPD_WIDTH - 1;
+    }
+    if (y1 >= EPD_HEIGHT)
+    {
+        y1 = EPD_HEIGHT - 1;
+    }
+    if (x0 > x1 || y0 > y1)
+    {
+        return false;
+    }
 
-    DigitalWrite(m_rst, LOW);
+    *px = x0;
+    *py = y0;
+    *pw = x1 - x0 + 1;
+    *ph = y1 - y0 + 1;
+    return true;
 }
 
-/////////PAINT////////////
-
 /**
- *  @brief: clear the image
+ *  @brief: private function to translate frame buffer coordinates
+ *          back to rotated coordinates, the inverse of MapPoint
  */
-void Epd::ClearFramebuffer(unsigned char *frame_buffer, int colored)//
+void Epd::UnmapPoint(int px, int py, int *x, int *y)
 {
-    for (int x = 0; x < this->width; x++)
+    if (rotate == ROTATE_90)
     {
-        for (int y = 0; y < this->height; y++)
-        {
-            SetAbsolutePixel(frame_buffer, x, y, colored);
-        }
+        *x = py;
+        *y = EPD_WIDTH - 1 - px;
     }
-}
-
-void Epd::SetRotate(int rotate)
-{
-    if (rotate == ROTATE_0)
+    else if (rotate == ROTATE_180)
     {
-        rotate = ROTATE_0;
-        width = EPD_WIDTH;
-        height = EPD_HEIGHT;
+        *x = EPD_WIDTH - 1 - px;
+        *y = EPD_HEIGHT - 1 - py;
     }
-    else if (rotate == ROTATE_90)
+    else if (rotate == ROTATE_270)
     {
-        rotate = ROTATE_90;
-        width = EPD_HEIGHT;
-        height = EPD_WIDTH;
+        *x = EPD_HEIGHT - 1 - py;
+        *y = px;
     }
-    else if (rotate == ROTATE_180)
+    else
     {
-        rotate = ROTATE_180;
-        width = EPD_WIDTH;
-        height = EPD_HEIGHT;
+        *x = px;
+        *y = py;
     }
-    else if (rotate == ROTATE_270)
+}
+
+/**
+ *  @brief: private function to combine count bits, starting at bit offset
+ *          of bits, with one frame buffer row, a byte at a time.
+ *          mode is one of the BITMAP_ modes or BLEND_PAINT_COLORED /
+ *          BLEND_PAINT_UNCOLORED, which paint the set bits in that color.
+ *          the span must lie within the frame buffer.
+ */
+void Epd::BlendSpan(unsigned char *frame_buffer, int x, int y, const unsigned char *bits, int offset, int count, int mode)
+{
+    unsigned char *dst = &frame_buffer[(x + y * EPD_WIDTH) / 8];
+    int end = x + count;
+
+    while (x < end)
     {
-        rotate = ROTATE_270;
-        width = EPD_HEIGHT;
-        height = EPD_WIDTH;
+        int bit = x % 8;
+        int n = 8 - bit < end - x ? 8 - bit : end - x;
+        int shift = offset % 8;
+        const unsigned char *src = &bits[offset / 8];
+
+        /* the next n source bits, moved to their place in the byte */
+        unsigned char value = *src << shift;
+        if (shift != 0 && n > 8 - shift)
+        {
+            value |= src[1] >> (8 - shift);
+        }
+        unsigned char mask = (unsigned char)(0xFF << (8 - n)) >> bit;
+        value = (value >> bit) & mask;
+
+        switch (mode)
+        {
+        case BITMAP_COPY:
+            *dst = (*dst & ~mask) | value;
+            break;
+        case BITMAP_OR:
+            *dst |= value;
+            break;
+        case BITMAP_AND:
+        case BITMAP_TRANSPARENT:
+            *dst &= value | ~mask;
+            break;
+        case BITMAP_XOR:
+            *dst ^= value;
+            break;
+        case BLEND_PAINT_COLORED:
+            *dst &= ~value;
+            break;
+        default:
+            *dst |= value;
+            break;
+        }
+        dst++;
+        x += n;
+        offset += n;
     }
 }
 
-void Epd::SetPixel(unsigned char *frame_buffer, int x, int y, int colored)//
+/**
+ *  @brief: private function to combine a w x h bitmap at x, y in rotated
+ *          coordinates with the frame buffer, see BlendSpan for the modes.
+ *          a stride of 0 repeats the first bitmap row h times.
+ */
+void Epd::BlendRect(unsigned char *frame_buffer, int x, int y, const unsigned char *bits, int stride, int w, int h, int mode)
 {
-    if (x < 0 || x >= width || y < 0 || y >= height)
+    int px, py, pw, ph;
+    unsigned char row[EPD_WIDTH / 8 + 1];
+
+    if (!MapRect(x, y, w, h, &px, &py, &pw, &ph))
     {
         return;
     }
-    if (rotate == ROTATE_0)
-    {
-        SetAbsolutePixel(frame_buffer, x, y, colored);
-    }
-    else if (rotate == ROTATE_90)
-    {
-        int point_temp = x;
-        x = EPD_WIDTH - y;
-        y = point_temp;
-        SetAbsolutePixel(frame_buffer, x, y, colored);
-    }
-    else if (rotate == ROTATE_180)
-    {
-        x = EPD_WIDTH - x;
-        y = EPD_HEIGHT - y;
-        SetAbsolutePixel(frame_buffer, x, y, colored);
-    }
-    else if (rotate == ROTATE_270)
+
+    for (int qy = py; qy < py + ph; qy++)
     {
-        int point_temp = x;
-        x = y;
-        y = EPD_HEIGHT - point_temp;
-        SetAbsolutePixel(frame_buffer, x, y, colored);
+        if (rotate == ROTATE_0)
+        {
+            BlendSpan(frame_buffer, px, qy, &bits[(qy - y) * stride], px - x, pw, mode);
+            continue;
+        }
+
+        /* gather the bitmap pixels that land on this frame buffer row */
+        int i, j, di, dj;
+        UnmapPoint(px + 1, qy, &di, &dj);
+        UnmapPoint(px, qy, &i, &j);
+        di -= i;
+        dj -= j;
+        i -= x;
+        j -= y;
+        memset(row, 0, (pw + 7) / 8);
+        for (int k = 0; k < pw; k++, i += di, j += dj)
+        {
+            if (bits[j * stride + i / 8] & (0x80 >> (i % 8)))
+            {
+                row[k / 8] |= 0x80 >> (k % 8);
+            }
+        }
+        BlendSpan(frame_buffer, px, qy, row, 0, pw, mode);
     }
 }
 
+
 void Epd::SetAbsolutePixel(unsigned char *frame_buffer, int x, int y, int colored)//
 {
     // To avoid display orientation effects
@@ -599,18 +1880,12 @@ void Epd::DrawLine(unsigned char *frame_buffer, int x0, int y0, int x1, int y1,
 
 void Epd::DrawHorizontalLine(unsigned char *frame_buffer, int x, int y, int width, int colored)
 {
-    for (int i = x; i < x + width; i++)
-    {
-        SetPixel(frame_buffer, i, y, colored);
-    }
+    FillRect(frame_buffer, x, y, width, 1, colored);
 }
 
 void Epd::DrawVerticalLine(unsigned char *frame_buffer, int x, int y, int height, int colored)
 {
-    for (int i = y; i < y + height; i++)
-    {
-        SetPixel(frame_buffer, x, i, colored);
-    }
+    FillRect(frame_buffer, x, y, 1, height, colored);
 }
 
 void Epd::DrawRectangle(unsigned char *frame_buffer, int x0, int y0, int x1, int y1, int colored)
@@ -632,9 +1907,60 @@ void Epd::DrawFilledRectangle(unsigned char *frame_buffer, int x0, int y0, int x
     int min_y = y1 > y0 ? y0 : y1;
     int max_y = y1 > y0 ? y1 : y0;
 
-    for (int i = min_x; i < max_x + 1; i++)
+    FillRect(frame_buffer, min_x, min_y, max_x - min_x + 1, max_y - min_y + 1, colored);
+}
+
+/**
+ *  @brief: private function to fill a w x h rectangle in rotated
+ *          coordinates, one frame buffer span per row
+ */
+void Epd::FillRect(unsigned char *frame_buffer, int x, int y, int w, int h, int colored)
+{
+    int px, py, pw, ph;
+
+    if (!MapRect(x, y, w, h, &px, &py, &pw, &ph))
+    {
+        return;
+    }
+    for (int j = py; j < py + ph; j++)
+    {
+        FillSpan(frame_buffer, px, j, pw, colored);
+    }
+}
+
+/**
+ *  @brief: private function to set count pixels of one frame buffer row
+ *          to colored, whole bytes at a time.
+ *          the span must lie within the frame buffer.
+ */
+void Epd::FillSpan(unsigned char *frame_buffer, int x, int y, int count, int colored)
+{
+    unsigned char *dst = &frame_buffer[(x + y * EPD_WIDTH) / 8];
+    int first = x % 8;
+    int last = (x + count) % 8;
+    int bytes = (first + count) / 8;
+    unsigned char fill = colored ? 0x00 : 0xFF;
+
+    if (bytes == 0)
+    {
+        /* the span starts and ends within one byte */
+        unsigned char bits = (unsigned char)(0xFF >> first) & (unsigned char)(0xFF << (8 - last));
+        *dst = colored ? (*dst & ~bits) : (*dst | bits);
+        return;
+    }
+    if (first != 0)
+    {
+        unsigned char bits = 0xFF >> first;
+        *dst = colored ? (*dst & ~bits) : (*dst | bits);
+        dst++;
+        bytes--;
+    }
+    memset(dst, fill, bytes);
+    if (last != 0)
     {
-        DrawVerticalLine(frame_buffer, i, min_y, max_y - min_y + 1, colored);
+        unsigned char bits = (unsigned char)(0xFF << (8 - last));
+        dst += bytes;
+        *dst = colored ? (*dst & ~bits) : (*dst | bits);
     }
 }
 
@@ -722,8 +2048,12 @@ void Epd::DrawFilledCircle(unsigned char *frame_buffer, int x, int y, int radius
 void Epd::DrawCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, sFONT *font, int colored)
 {
     int i, j;
-    unsigned int char_offset = (ascii_char - ' ') * font->Height * (font->Width / 8 + (font->Width % 8 ? 1 : 0));
-    const unsigned char *ptr = &font->table[char_offset];
+    const unsigned char *ptr = GlyphAt(ascii_char, font);
+
+    if (ptr == NULL)
+    {
+        return;
+    }
 
     for (j = 0; j < font->Height; j++)
     {
@@ -745,6 +2075,362 @@ void Epd::DrawCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char,
     }
 }
 
+/**
+ *  @brief: this draws a charactor scaled up by an integer factor
+ *          (2 to MAX_TEXT_SCALE) on the frame buffer but not refresh.
+ *          each glyph row is widened byte-wise and painted scale times.
+ */
+void Epd::DrawScaledCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, sFONT *font, int colored, int scale)
+{
+    int bytes_per_row = font->Width / 8 + (font->Width % 8 ? 1 : 0);
+    unsigned char row[(MAX_WIDTH_FONT + 7) / 8 * MAX_TEXT_SCALE];
+    const unsigned char *ptr;
+
+    if (scale <= 1)
+    {
+        DrawCharAt(frame_buffer, x, y, ascii_char, font, colored);
+        return;
+    }
+    if (scale > MAX_TEXT_SCALE)
+    {
+        scale = MAX_TEXT_SCALE;
+    }
+    ptr = GlyphAt(ascii_char, font);
+    if (ptr == NULL || bytes_per_row * scale > (int)sizeof(row))
+    {
+        return;
+    }
+
+    const unsigned short *widen = scale_nibble[scale - 2];
+    for (int j = 0; j < font->Height; j++)
+    {
+        unsigned long acc = 0;
+        int acc_bits = 0;
+        int n = 0;
+
+        for (int i = 0; i < bytes_per_row; i++)
+        {
+            acc = (acc << (4 * scale)) | widen[ptr[i] >> 4];
+            acc = (acc << (4 * scale)) | widen[ptr[i] & 0x0F];
+            acc_bits += 8 * scale;
+            while (acc_bits >= 8)
+            {
+                acc_bits -= 8;
+                row[n++] = (unsigned char)(acc >> acc_bits);
+            }
+        }
+        /* one widened row covers scale rows of the frame buffer */
+        PaintMask(frame_buffer, x, y + j * scale, row, 0, font->Width * scale, scale, colored);
+        ptr += bytes_per_row;
+    }
+}
+
+/**
+ *  @brief: this displays a string scaled up by an integer factor
+ *          on the frame buffer but not refresh
+ */
+void Epd::DrawScaledStringAt(unsigned char *frame_buffer, int x, int y, const char *text, sFONT *font, int colored, int scale)
+{
+    int advance = font->Width * (scale < 1 ? 1 : scale > MAX_TEXT_SCALE ? MAX_TEXT_SCALE : scale);
+
+    for (const char *p_text = text; *p_text != 0; p_text++)
+    {
+        DrawScaledCharAt(frame_buffer, x, y, *p_text, font, colored, scale);
+        x += advance;
+    }
+}
+
+/* gather the bits 7, 5, 3 and 1 of a byte into a nibble */
+static inline unsigned char OddBits(unsigned char b)
+{
+    b = (b >> 1) & 0x55;
+    b = (b | (b >> 1)) & 0x33;
+    return (b | (b >> 2)) & 0x0F;
+}
+
+/* spread a nibble to the bits 7, 5, 3 and 1 of a byte */
+static inline unsigned char SpreadBits(unsigned int v)
+{
+    return ((v & 8) << 4) | ((v & 4) << 3) | ((v & 2) << 2) | ((v & 1) << 1);
+}
+
+/**
+ *  @brief: this draws an anti-aliased charactor on the frame buffer
+ *          but not refresh. the coverage is dithered 8 pixels at a time
+ *          against a 4x4 Bayer matrix anchored to x, y = 0, 0.
+ */
+void Epd::DrawGrayCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, const sFONTGRAY *font, int colored)
+{
+    unsigned int index = (unsigned char)ascii_char - FONT_FIRST_CHAR;
+    int bytes_per_row = (font->Width * font->Bits + 7) / 8;
+    int phase = ((x % 4) + 4) % 4;
+    unsigned char row[8];
+
+    if (index >= FONT_GLYPH_COUNT || (font->Bits != 2 && font->Bits != 4) || font->Width > 8 * (int)sizeof(row))
+    {
+        return;
+    }
+    const unsigned char *ptr = &font->table[index * font->Height * bytes_per_row];
+
+    for (int j = 0; j < font->Height; j++, ptr += bytes_per_row)
+    {
+        int r = (((y + j) % 4) + 4) % 4;
+        int n = 0;
+
+        if (font->Bits == 2)
+        {
+            unsigned char level1 = (unsigned char)((dither_level1[r] << phase) | (dither_level1[r] >> (8 - phase)));
+            unsigned char level2 = (unsigned char)((dither_level2[r] << phase) | (dither_level2[r] >> (8 - phase)));
+
+            for (int i = 0; i < bytes_per_row; i += 2)
+            {
+                unsigned char b0 = ptr[i];
+                unsigned char b1 = i + 1 < bytes_per_row ? ptr[i + 1] : 0;
+                unsigned char hi = (OddBits(b0) << 4) | OddBits(b1);
+                unsigned char lo = (OddBits(b0 << 1) << 4) | OddBits(b1 << 1);
+
+                row[n++] = (~hi & lo & level1) | (hi & ~lo & level2) | (hi & lo);
+            }
+        }
+        else
+        {
+            const unsigned char *t = dither_threshold[r];
+            unsigned long even = (unsigned long)t[phase] << 24 | (unsigned long)t[(phase + 2) % 4] << 16 |
+                                 (unsigned long)t[phase] << 8 | t[(phase + 2) % 4];
+            unsigned long odd = (unsigned long)t[(phase + 1) % 4] << 24 | (unsigned long)t[(phase + 3) % 4] << 16 |
+                                (unsigned long)t[(phase + 1) % 4] << 8 | t[(phase + 3) % 4];
+
+            for (int i = 0; i < bytes_per_row; i += 4)
+            {
+                unsigned long w = 0;
+                for (int k = 0; k < 4; k++)
+                {
+                    w = (w << 8) | (i + k < bytes_per_row ? ptr[i + k] : 0);
+                }
+                /* per byte lane: top bit set where level > threshold */
+                unsigned long ev = ((((w >> 4) & 0x0F0F0F0FUL) | 0x80808080UL) - even - 0x01010101UL) & 0x80808080UL;
+                unsigned long od = (((w & 0x0F0F0F0FUL) | 0x80808080UL) - odd - 0x01010101UL) & 0x80808080UL;
+                ev = ((ev >> 28) & 8) | ((ev >> 21) & 4) | ((ev >> 14) & 2) | ((ev >> 7) & 1);
+                od = ((od >> 28) & 8) | ((od >> 21) & 4) | ((od >> 14) & 2) | ((od >> 7) & 1);
+
+                row[n++] = SpreadBits(ev) | (SpreadBits(od) >> 1);
+            }
+        }
+        PaintMask(frame_buffer, x, y + j, row, 0, font->Width, 1, colored);
+    }
+}
+
+/**
+ *  @brief: draw an anti-aliased char into a gray buffer in level,
+ *          GRAY_BLACK..GRAY_WHITE. each pixel moves from what is there
+ *          towards level by its coverage, so the edges come out in the
+ *          gray levels between.
+ */
+void Epd::DrawGrayBufferCharAt(unsigned char *gray_buffer, int x, int y, char ascii_char, const sFONTGRAY *font, int level)
+{
+    unsigned int index = (unsigned char)ascii_char - FONT_FIRST_CHAR;
+    int bytes_per_row = (font->Width * font->Bits + 7) / 8;
+    int max_level = (1 << font->Bits) - 1;
+
+    if (index >= FONT_GLYPH_COUNT || (font->Bits != 2 && font->Bits != 4))
+    {
+        return;
+    }
+    const unsigned char *ptr = &font->table[index * font->Height * bytes_per_row];
+
+    for (int j = 0; j < font->Height; j++, ptr += bytes_per_row)
+    {
+        for (int i = 0; i < font->Width; i++)
+        {
+            int bit = i * font->Bits;
+            int coverage = (ptr[bit / 8] >> (8 - font->Bits - bit % 8)) & max_level;
+            if (coverage == 0)
+            {
+                continue;
+            }
+            int old = GetGrayPixel(gray_buffer, x + i, y + j);
+            if (old < 0)
+            {
+                continue;
+            }
+            /* rounded to the nearer level */
+            int diff = (level - old) * coverage;
+            int step = (diff + (diff < 0 ? -max_level / 2 : max_level / 2)) / max_level;
+            SetGrayPixel(gray_buffer, x + i, y + j, old + step);
+        }
+    }
+}
+
+/**
+ *  @brief: like DrawGrayStringAt, into a gray buffer
+ */
+void Epd::DrawGrayBufferStringAt(unsigned char *gray_buffer, int x, int y, const char *text, const sFONTGRAY *font, int level)
+{
+    for (const char *p_text = text; *p_text != 0; p_text++)
+    {
+        DrawGrayBufferCharAt(gray_buffer, x, y, *p_text, font, level);
+        x += font->Width;
+    }
+}
+
+/**
+ *  @brief: this displays an anti-aliased string on the frame buffer
+ *          but not refresh
+ */
+void Epd::DrawGrayStringAt(unsigned char *frame_buffer, int x, int y, const char *text, const sFONTGRAY *font, int colored)
+{
+    for (const char *p_text = text; *p_text != 0; p_text++)
+    {
+        DrawGrayCharAt(frame_buffer, x, y, *p_text, font, colored);
+        x += font->Width;
+    }
+}
+
+/**
+ *  @brief: private function to paint a w x h mask in rotated coordinates,
+ *          set bits are painted in colored. a stride of 0 repeats the
+ *          first mask row h times.
+ */
+void Epd::PaintMask(unsigned char *frame_buffer, int x, int y, const unsigned char *mask, int stride, int w, int h, int colored)
+{
+    BlendRect(frame_buffer, x, y, mask, stride, w, h, colored ? BLEND_PAINT_COLORED : BLEND_PAINT_UNCOLORED);
+}
+
+/**
+ *  @brief: this draws a 1-bit bitmap in frame buffer format (0 is black,
+ *          msb first, rows padded to whole bytes) at any x, y, clipped
+ *          to the display and rotated like the other drawing functions.
+ *          mode combines the bitmap with what is already drawn:
+ *          BITMAP_COPY replaces it, BITMAP_OR, BITMAP_AND and BITMAP_XOR
+ *          apply that operation to the bits, BITMAP_TRANSPARENT only draws
+ *          the black bitmap pixels, which for this format is BITMAP_AND.
+ */
+void Epd::DrawBitmap(unsigned char *frame_buffer, const unsigned char *bitmap, int x, int y, int bitmap_width, int bitmap_height, int mode)
+{
+    if (bitmap == NULL || mode < BITMAP_COPY || mode > BITMAP_TRANSPARENT)
+    {
+        return;
+    }
+    BlendRect(frame_buffer, x, y, bitmap, (bitmap_width + 7) / 8, bitmap_width, bitmap_height, mode);
+}
+
+/**
+ *  @brief: draw strings through a cache of their rendered masks,
+ *          NULL turns caching off again.
+ *          the cache must outlive its use by this Epd.
+ */
+void Epd::SetTextCache(TextCache *cache)
+{
+    text_cache = cache;
+}
+
+/**
+ *  @brief: private function to draw a string from the text cache,
+ *          rendering it into a new entry on a miss
+ */
+void Epd::DrawStringCached(unsigned char *frame_buffer, int x, int y, const char *text, sFONT *font, int colored)
+{
+    unsigned int length = strlen(text);
+    int text_width = length * font->Width;
+    int px, py, pw, ph;
+    int cx, cy, cw, ch;
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    /* the whole mask, unclipped, in frame buffer orientation */
+    MapPoint(x, y, &px, &py);
+    MapPoint(x + text_width - 1, y + font->Height - 1, &cx, &cy);
+    pw = (cx > px ? cx - px : px - cx) + 1;
+    ph = (cy > py ? cy - py : py - cy) + 1;
+    px = cx < px ? cx : px;
+    py = cy < py ? cy : py;
+
+    TextCache::Entry *entry = text_cache->Find(text, length, font, rotate);
+    if (entry == NULL)
+    {
+        entry = text_cache->Insert(text, length, font, rotate, pw, ph);
+        if (entry == NULL)
+        {
+            /* too large for the cache */
+            for (unsigned int k = 0; k < length; k++)
+            {
+                DrawCharAt(frame_buffer, x + k * font->Width, y, text[k], font, colored);
+            }
+            return;
+        }
+
+        int stride = (pw + 7) / 8;
+        for (unsigned int k = 0; k < length; k++)
+        {
+            const unsigned char *ptr = GlyphAt(text[k], font);
+            if (ptr == NULL)
+            {
+                continue;
+            }
+            for (int j = 0; j < font->Height; j++)
+            {
+                for (int i = 0; i < font->Width; i++)
+                {
+                    if (*ptr & (0x80 >> (i % 8)))
+                    {
+                        int qx, qy;
+                        MapPoint(x + k * font->Width + i, y + j, &qx, &qy);
+                        qx -= px;
+                        qy -= py;
+                        entry->bits[qx / 8 + qy * stride] |= 0x80 >> (qx % 8);
+                    }
+                    if (i % 8 == 7)
+                    {
+                        ptr++;
+                    }
+                }
+                if (font->Width % 8 != 0)
+                {
+                    ptr++;
+                }
+            }
+        }
+    }
+
+    /* blit the visible part row by row */
+    if (!MapRect(x, y, text_width, font->Height, &cx, &cy, &cw, &ch))
+    {
+        return;
+    }
+    int stride = (entry->width + 7) / 8;
+    for (int j = cy; j < cy + ch; j++)
+    {
+        BlendSpan(frame_buffer, cx, j, &entry->bits[(j - py) * stride], cx - px, cw,
+                  colored ? BLEND_PAINT_COLORED : BLEND_PAINT_UNCOLORED);
+    }
+}
+
+/**
+ *  @brief: locate the bitmap of a charactor in the font table,
+ *          returns NULL if the font has no glyph for it
+ */
+const unsigned char *Epd::GlyphAt(char ascii_char, sFONT *font)
+{
+    unsigned int index = (unsigned char)ascii_char - FONT_FIRST_CHAR;
+
+    if (index >= FONT_GLYPH_COUNT)
+    {
+        return NULL;
+    }
+    if (font->map != NULL)
+    {
+        if (font->map[index] == FONT_NO_GLYPH)
+        {
+            return NULL;
+        }
+        index = font->map[index];
+    }
+    return &font->table[index * font->Height * (font->Width / 8 + (font->Width % 8 ? 1 : 0))];
+}
+
 /**
 *  @brief: this displays a string on the frame buffer but not refresh
 */
@@ -754,6 +2440,12 @@ void Epd::DrawStringAt(unsigned char *frame_buffer, int x, int y, const char *te
     unsigned int counter = 0;
     int refcolumn = x;
 
+    if (text_cache != NULL)
+    {
+        DrawStringCached(frame_buffer, x, y, text, font, colored);
+        return;
+    }
+
     /* Send the string character by character on EPD */
     while (*p_text != 0)
     {
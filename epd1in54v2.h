@@ -29,7 +29,10 @@
 
 #include "epdif.h"
 #include "fonts.h"
+#include "fontgray.h"
 #include "imagedata.h"
+#include "imagepack.h"
+#include "textcache.h"
 
 #define LOW 0
 #define HIGH 1
@@ -41,6 +44,16 @@
 #define COLORED 1
 #define UNCOLORED 0
 
+// DrawBitmap modes, combining the bitmap bits with the frame buffer
+#define BITMAP_COPY 0
+#define BITMAP_OR 1
+#define BITMAP_AND 2
+#define BITMAP_XOR 3
+#define BITMAP_TRANSPARENT 4
+
+// Largest factor of DrawScaledCharAt / DrawScaledStringAt
+#define MAX_TEXT_SCALE 4
+
 // EPD1IN54 commands
 #define DRIVER_OUTPUT_CONTROL 0x01
 #define BOOSTER_SOFT_START_CONTROL 0x0C
@@ -72,11 +85,109 @@
 
 #define IF_INVERT_COLOR     1
  
+// Reset and BUSY timing in ms, see SetResetTiming and SetBusyTimeout
+#ifndef EPD_RESET_PULSE_MS
+#define EPD_RESET_PULSE_MS 10
+#endif
+#ifndef EPD_RESET_SETTLE_MS
+#define EPD_RESET_SETTLE_MS 1
+#endif
+#ifndef EPD_BUSY_TIMEOUT
+#define EPD_BUSY_TIMEOUT 500
+#endif
+// Longest refresh in ms, see SetRefreshTimeout
+#ifndef EPD_REFRESH_TIMEOUT
+#define EPD_REFRESH_TIMEOUT 4000
+#endif
+
+// Return codes
+#define EPD_OK 0
+#define EPD_ERROR_INTERFACE -1       /* IfInit failed */
+#define EPD_ERROR_BUSY_TIMEOUT -2    /* BUSY stuck after a reset or command */
+#define EPD_ERROR_REFRESH_TIMEOUT -3 /* BUSY stuck after a refresh */
+#define EPD_ERROR_SLEEPING -4        /* refresh in deep sleep, call Wake */
+#define EPD_RECOVERED -5             /* refresh timed out, Recover put the recovery frame back */
+
+// Deep sleep modes, see Sleep
+#define SLEEP_MODE_1 0x01
+#define SLEEP_MODE_2 0x03
+
+// Gray buffer, 2 bits per pixel msb first
+#define GRAY_BLACK 0
+#define GRAY_DARK 1
+#define GRAY_LIGHT 2
+#define GRAY_WHITE 3
+#define EPD_GRAY_BUFFER_SIZE (EPD_WIDTH / 4 * EPD_HEIGHT)
+
+// Frame buffer, 1 bit per pixel
+#define EPD_BUFFER_SIZE (EPD_WIDTH / 8 * EPD_HEIGHT)
+
+// Default ms between temperature reloads, see SetTemperatureInterval
+#ifndef EPD_TEMPERATURE_INTERVAL
+#define EPD_TEMPERATURE_INTERVAL 60000
+#endif
+
+// Waveform: 153 bytes for 0x32, then EOPT, VGH, VSH1, VSH2, VSL, VCOM
+#define EPD_LUT_SIZE 159
+
+/* waveforms used from min_celsius up to the next band, see SetLutBands */
+struct EpdLutBand
+{
+    int min_celsius;
+    const unsigned char *lut_full;
+    const unsigned char *lut_partial;
+};
+
+/* currents in uA and charges in nC, see Epd::SetPowerModel */
+struct EpdPowerModel
+{
+    unsigned long refresh_ua; /* BUSY during a refresh */
+    unsigned long busy_ua;    /* BUSY otherwise: reset, waveform load */
+    unsigned long idle_ua;    /* awake, not busy */
+    unsigned long sleep_ua;   /* deep sleep */
+    unsigned long byte_nc;    /* per byte sent */
+    unsigned long reset_nc;   /* per reset */
+};
+
+extern const EpdPowerModel epd_default_power_model;
+
+/* times in ms of Epd::GetMs */
+struct EpdEnergyStats
+{
+    unsigned long resets;
+    unsigned long inits;
+    unsigned long wakes;
+    unsigned long full_refreshes;
+    unsigned long partial_refreshes;
+    unsigned long bytes_sent;
+    unsigned long ram_bytes;
+    unsigned long busy_ms;
+    unsigned long refresh_ms;
+    unsigned long sleep_ms;
+    unsigned long start_ms;
+    unsigned long last_reset_ms;
+    unsigned long last_refresh_ms;
+    unsigned long sleep_since_ms;
+};
+
+/* see Epd::GetErrorStats */
+struct EpdErrorStats
+{
+    unsigned long busy_timeouts;
+    unsigned long refresh_timeouts;
+    unsigned long recoveries;
+    unsigned long failed_recoveries;
+    int last_error;
+};
+
 extern const unsigned char lut_full_update[];
 extern const unsigned char lut_partial_update[];
+extern const unsigned char lut_4gray[];
 
 class Epd : EpdIf
 {
+    friend class FrameMemoryWriter;
+
 public:
     unsigned long width;
     unsigned long height;
@@ -89,22 +200,46 @@ public:
         PinName dc,
         PinName rst,
         PinName busy);
+    Epd(SPI *spi,
+        PinName cs,
+        PinName dc,
+        PinName rst,
+        PinName busy,
+        int frequency);
     ~Epd();
     // int  Init(const unsigned char* lut);
     int LDirInit(void);//new
     int HDirInit(void);//new
     void SendCommand(unsigned char command);
     void SendData(unsigned char data);
-    void WaitUntilIdle(void);
+    void SendData(const unsigned char *data, int length);
+    using EpdIf::GetMs;
+    int WaitUntilIdle(void);
     void Reset(void);
-    void ClearDisplay(void);//new
+    void SetResetTiming(unsigned int pulse_ms, unsigned int settle_ms);
+    void SetBusyTimeout(unsigned long timeout_ms);
+    void SetRefreshTimeout(unsigned long timeout_ms);
+    void SetAutoRecover(bool enable);
+    void SetRecoveryFrame(const unsigned char *frame_buffer);
+    int Recover(void);
+    const EpdErrorStats &GetErrorStats(void);
+    void ResetErrorStats(void);
+    void SetPowerModel(const EpdPowerModel &model);
+    const EpdEnergyStats &GetEnergyStats(void);
+    void ResetEnergyStats(void);
+    float GetChargeMah(void);
+    int ClearDisplay(void);//new
 
-    void Display(const unsigned char *frame_buffer);//new
-    void DisplayPartBaseImage(const unsigned char *frame_buffer);//new
-    void DisplayPartBaseWhiteImage(void);//new
-    void DisplayPart(const unsigned char *frame_buffer);//new
+    int Display(const unsigned char *frame_buffer);//new
+    int DisplayPartBaseImage(const unsigned char *frame_buffer);//new
+    int DisplayPartBaseWhiteImage(void);//new
+    int DisplayPart(const unsigned char *frame_buffer);//new
+    int DisplayPartArea(const unsigned char *frame_buffer, int x, int y, int w, int h);
 
-    // void SetLut(const unsigned char* lut);
+    int SetLut(const unsigned char *lut);
+    int PartInit(void);
+    int GrayInit(void);
+    int DisplayGray(const unsigned char *gray_buffer);
 
     void SetFrameMemory(
         const unsigned char *image_buffer,
@@ -112,12 +247,28 @@ public:
         int y,
         int image_width,
         int image_height);
+    void SetFrameMemoryPacked(const unsigned char *packed_image, int x, int y);
     // void ClearFrameMemory(unsigned char color);
 
-    void DisplayFrame(void);
-    void DisplayPartFrame(void);
+    int DisplayFrame(void);
+    int DisplayPartFrame(void);
+    void UploadFrame(const unsigned char *frame_buffer);
+    void UploadBaseImage(const unsigned char *frame_buffer);
+    int StartRefresh(bool partial);
+    bool IsBusy(void);
+    bool IsRefreshing(void);
+    bool RefreshTimedOut(void);
+    int FinishRefresh(void);
+    int AutoRecover(int result);
+    void SetTemperatureInterval(unsigned long interval_ms);
+    void SetAnalogHold(bool hold);
+    void SetTemperature(int celsius);
+    void UseInternalTemperature(void);
+    void SetLutBands(const EpdLutBand *bands, int count);
 
-    void Sleep(void);
+    int Sleep(void);
+    int Sleep(int mode);
+    int Wake(void);
 
     //Paint
 
@@ -134,10 +285,85 @@ public:
     void DrawFilledCircle(unsigned char *frame_buffer, int x, int y, int radius, int colored);
     void DrawCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, sFONT *font, int colored);
     void DrawStringAt(unsigned char *frame_buffer, int x, int y, const char *text, sFONT *font, int colored);
+    void DrawScaledCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, sFONT *font, int colored, int scale);
+    void DrawScaledStringAt(unsigned char *frame_buffer, int x, int y, const char *text, sFONT *font, int colored, int scale);
+    void DrawGrayCharAt(unsigned char *frame_buffer, int x, int y, char ascii_char, const sFONTGRAY *font, int colored);
+    void DrawGrayStringAt(unsigned char *frame_buffer, int x, int y, const char *text, const sFONTGRAY *font, int colored);
+    void DrawGrayBufferCharAt(unsigned char *gray_buffer, int x, int y, char ascii_char, const sFONTGRAY *font, int level);
+    void DrawGrayBufferStringAt(unsigned char *gray_buffer, int x, int y, const char *text, const sFONTGRAY *font, int level);
+    void DrawBitmap(unsigned char *frame_buffer, const unsigned char *bitmap, int x, int y, int bitmap_width, int bitmap_height, int mode);
+    void SetTextCache(TextCache *cache);
+
+    void ClearGrayFramebuffer(unsigned char *gray_buffer, int level);
+    void SetGrayPixel(unsigned char *gray_buffer, int x, int y, int level);
+    void DrawGrayImage(unsigned char *gray_buffer, const unsigned char *image, int x, int y, int image_width, int image_height);
 
 private:
+    TextCache *text_cache;
+    /* HDirInit fills the display RAM bottom row first */
+    bool ram_y_reversed;
+    /* waveform loaded by SetLut, NULL while the OTP one is used */
+    const unsigned char *current_lut;
+    /* what the controller has loaded, see UpdateSequence */
+    bool analog_on;
+    bool analog_hold;
+    bool temperature_loaded;
+    unsigned long temperature_ms;
+    unsigned long temperature_interval;
+    int otp_lut_mode;
+    bool external_temperature;
+    int temperature_celsius;
+    const EpdLutBand *lut_bands;
+    int lut_band_count;
+    /* PartInit's register settings are in use */
+    bool partial_options;
+    bool sleeping;
+    unsigned int reset_pulse;
+    unsigned int reset_settle;
+    unsigned long busy_timeout;
+    unsigned long refresh_timeout;
+    bool auto_recover;
+    bool recovering;
+    /* whole frame buffer uploaded last, for Recover */
+    const unsigned char *last_frame;
+    /* set by the owner, used by Recover instead of last_frame */
+    const unsigned char *recovery_frame;
+    EpdErrorStats errors;
+    unsigned char last_command;
+    EpdPowerModel power_model;
+    EpdEnergyStats energy;
+    /* StartRefresh ran, FinishRefresh didn't yet */
+    bool refreshing;
+    unsigned long refresh_started_ms;
+
+    void SetDefaults(void);
+    void SendFill(unsigned char data, int length);
+    void SendGrayPlane(const unsigned char *gray_buffer, int shift);
+    int GetGrayPixel(const unsigned char *gray_buffer, int x, int y);
+    unsigned char UpdateSequence(int mode);
+    void ForgetUpdateState(void);
+    int SendConfig(void);
+    int SendPartialOptions(void);
+    void Activate(int mode);
+    int WaitBusy(unsigned long timeout, unsigned long *waited);
+    void CountData(int length);
+    void EndSleep(void);
+    void SendTemperature(void);
+    int SelectBandLut(int mode);
+
+    const unsigned char *GlyphAt(char ascii_char, sFONT *font);
+    void MapPoint(int x, int y, int *px, int *py);
+    bool MapRect(int x, int y, int w, int h, int *px, int *py, int *pw, int *ph);
+    void FillRect(unsigned char *frame_buffer, int x, int y, int w, int h, int colored);
+    void FillSpan(unsigned char *frame_buffer, int x, int y, int count, int colored);
+    void UnmapPoint(int px, int py, int *x, int *y);
+    void BlendSpan(unsigned char *frame_buffer, int x, int y, const unsigned char *bits, int offset, int count, int mode);
+    void BlendRect(unsigned char *frame_buffer, int x, int y, const unsigned char *bits, int stride, int w, int h, int mode);
+    void PaintMask(unsigned char *frame_buffer, int x, int y, const unsigned char *mask, int stride, int w, int h, int colored);
+    void DrawStringCached(unsigned char *frame_buffer, int x, int y, const char *text, sFONT *font, int colored);
     void SetMemoryArea(int x_start, int y_start, int x_end, int y_end);
     void SetMemoryPointer(int x, int y);
+    void SetRamWindow(int x_start, int x_end, int first_row, int last_row);
 };
 
 #endif /* EPD1IN54V2_H */
@@ -0,0 +1,196 @@
+/**
+ *  @filename   :   epdasync.cpp
+ *  @brief      :   Implements the coroutine calls and executors
+ */
+
+#include "epdasync.h"
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+EpdLoop::EpdLoop(void) : m_count(0)
+{
+    m_timer.start();
+}
+
+int EpdLoop::Schedule(std::coroutine_handle<> handle, unsigned long delay_ms)
+{
+    if (m_count >= EPD_LOOP_MAX)
+    {
+        return -1;
+    }
+    m_entries[m_count].handle = handle;
+    m_entries[m_count].due_ms = m_timer.read_ms() + delay_ms;
+    m_count++;
+    return 0;
+}
+
+/**
+ *  @brief: resume the coroutines that are due. returns the ms to the
+ *          next one, or -1 if none is waiting.
+ */
+int EpdLoop::Poll(void)
+{
+    unsigned long now = m_timer.read_ms();
+
+    for (int i = 0; i < m_count;)
+    {
+        if ((long)(m_entries[i].due_ms - now) <= 0)
+        {
+            std::coroutine_handle<> handle = m_entries[i].handle;
+            /* the resumed coroutine may schedule again */
+            m_entries[i] = m_entries[--m_count];
+            handle.resume();
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    int next = -1;
+    now = m_timer.read_ms();
+    for (int i = 0; i < m_count; i++)
+    {
+        long left = (long)(m_entries[i].due_ms - now);
+        if (left < 0)
+        {
+            left = 0;
+        }
+        if (next < 0 || left < next)
+        {
+            next = left;
+        }
+    }
+    return next;
+}
+
+/**
+ *  @brief: run until no coroutine is waiting
+ */
+void EpdLoop::Run(void)
+{
+    int next;
+
+    while ((next = Poll()) >= 0)
+    {
+        if (next > 0)
+        {
+            wait_ms(next);
+        }
+    }
+}
+
+#if defined(__MBED__) && MBED_CONF_EVENTS_PRESENT
+EpdEventQueueExecutor::EpdEventQueueExecutor(events::EventQueue &queue) : m_queue(queue)
+{
+}
+
+int EpdEventQueueExecutor::Schedule(std::coroutine_handle<> handle, unsigned long delay_ms)
+{
+    int id = m_queue.call_in(delay_ms, &EpdEventQueueExecutor::Resume, handle.address());
+    return id != 0 ? 0 : -1;
+}
+
+void EpdEventQueueExecutor::Resume(void *address)
+{
+    std::coroutine_handle<>::from_address(address).resume();
+}
+#endif
+
+EpdAsync::EpdAsync(Epd &epd, EpdExecutor &executor) : m_epd(epd),
+                                                     m_executor(executor)
+{
+}
+
+/**
+ *  @brief: co_await Delay(ms) lets other coroutines run for ms
+ */
+EpdAsync::DelayAwaiter EpdAsync::Delay(unsigned long ms)
+{
+    return DelayAwaiter{m_executor, ms};
+}
+
+/**
+ *  @brief: wait for BUSY to drop and finish the refresh in progress.
+ *          returns EPD_OK, or EPD_ERROR_REFRESH_TIMEOUT once the
+ *          panel's refresh timeout, counted from the refresh start,
+ *          is over. FinishRefresh then doesn't block.
+ */
+EpdTask EpdAsync::WaitUntilIdle(void)
+{
+    while (m_epd.IsRefreshing() && m_epd.IsBusy() && !m_epd.RefreshTimedOut())
+    {
+        co_await Delay(EPD_ASYNC_POLL_MS);
+    }
+    co_return m_epd.FinishRefresh();
+}
+
+/**
+ *  @brief: HDirInit or LDirInit. the init only waits for the short
+ *          reset and waveform load, it is not split up.
+ */
+EpdTask EpdAsync::Init(bool high_direction)
+{
+    co_return high_direction ? m_epd.HDirInit() : m_epd.LDirInit();
+}
+
+EpdTask EpdAsync::Display(const unsigned char *frame_buffer)
+{
+    return Refresh(frame_buffer, false, false);
+}
+
+EpdTask EpdAsync::DisplayPartBaseImage(const unsigned char *frame_buffer)
+{
+    return Refresh(frame_buffer, true, false);
+}
+
+EpdTask EpdAsync::DisplayPart(const unsigned char *frame_buffer)
+{
+    return Refresh(frame_buffer, false, true);
+}
+
+/**
+ *  @brief: deep sleep once a refresh still running is done
+ */
+EpdTask EpdAsync::Sleep(int mode)
+{
+    int result = co_await WaitUntilIdle();
+    if (result != 0)
+    {
+        co_return result;
+    }
+    co_return m_epd.Sleep(mode);
+}
+
+/**
+ *  @brief: private function, the frame goes out over SPI as with the
+ *          blocking calls, the coroutine is suspended for the refresh
+ */
+EpdTask EpdAsync::Refresh(const unsigned char *frame_buffer, bool base, bool partial)
+{
+    int result = co_await WaitUntilIdle();
+    if (result != 0)
+    {
+        co_return result;
+    }
+    if (base)
+    {
+        m_epd.UploadBaseImage(frame_buffer);
+    }
+    else
+    {
+        m_epd.UploadFrame(frame_buffer);
+    }
+    result = m_epd.StartRefresh(partial);
+    if (result != EPD_OK)
+    {
+        co_return result;
+    }
+    result = co_await WaitUntilIdle();
+    /* the recovery itself blocks, as in Epd::DisplayFrame */
+    co_return m_epd.AutoRecover(result);
+}
+
+#endif /* C++20 coroutines */
+
+/* END OF FILE */
@@ -0,0 +1,237 @@
+/**
+ *  @filename   :   epdasync.h
+ *  @brief      :   Awaitable versions of the Epd calls, for C++20
+ *                  coroutines. A coroutine that awaits a refresh is
+ *                  suspended until BUSY drops instead of blocking the
+ *                  thread, so one thread can run several panels and
+ *                  other work side by side. Suspended coroutines are
+ *                  resumed by an EpdExecutor: EpdLoop, a small event
+ *                  loop for the host or a bare thread, or
+ *                  EpdEventQueueExecutor on an mbed EventQueue.
+ *                  Compiled only with coroutine support.
+ */
+
+#ifndef EPDASYNC_H
+#define EPDASYNC_H
+
+#include "epd1in54v2.h"
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+
+// ms between BUSY reads while a coroutine waits
+#ifndef EPD_ASYNC_POLL_MS
+#define EPD_ASYNC_POLL_MS 10
+#endif
+
+// Most coroutines waiting in an EpdLoop
+#ifndef EPD_LOOP_MAX
+#define EPD_LOOP_MAX 16
+#endif
+
+/**
+ *  @brief: resumes suspended coroutines. Schedule returns 0, or -1 if
+ *          it can't take the handle, then the caller waits itself.
+ */
+class EpdExecutor
+{
+public:
+    virtual ~EpdExecutor() {}
+    virtual int Schedule(std::coroutine_handle<> handle, unsigned long delay_ms) = 0;
+};
+
+/**
+ *  @brief: coroutine type of the EpdAsync calls, the result is an int
+ *          as from the blocking calls. it starts when awaited, or with
+ *          Start, and must outlive the coroutine.
+ */
+class EpdTask
+{
+public:
+    struct promise_type
+    {
+        int result;
+        std::coroutine_handle<> continuation;
+
+        promise_type() : result(0) {}
+        EpdTask get_return_object()
+        {
+            return EpdTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return std::suspend_always();
+        }
+        /* hand control back to the awaiting coroutine, if any */
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                std::coroutine_handle<> next = handle.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept
+        {
+            return FinalAwaiter();
+        }
+        void return_value(int value)
+        {
+            result = value;
+        }
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    explicit EpdTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    EpdTask(EpdTask &&other) noexcept : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+    EpdTask(const EpdTask &) = delete;
+    EpdTask &operator=(const EpdTask &) = delete;
+    ~EpdTask()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    /**
+     *  @brief: run a task nobody awaits, up to its first suspension
+     */
+    void Start(void)
+    {
+        if (m_handle && !m_handle.done())
+        {
+            m_handle.resume();
+        }
+    }
+    bool IsDone(void)
+    {
+        return !m_handle || m_handle.done();
+    }
+    int GetResult(void)
+    {
+        return m_handle.promise().result;
+    }
+
+    bool await_ready()
+    {
+        return IsDone();
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    int await_resume()
+    {
+        return GetResult();
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ *  @brief: event loop for the host or a thread of its own. call Poll
+ *          between other work, or Run until all coroutines are done.
+ */
+class EpdLoop : public EpdExecutor
+{
+public:
+    EpdLoop(void);
+
+    int Schedule(std::coroutine_handle<> handle, unsigned long delay_ms);
+    int Poll(void);
+    void Run(void);
+
+private:
+    struct Entry
+    {
+        std::coroutine_handle<> handle;
+        unsigned long due_ms;
+    };
+    Entry m_entries[EPD_LOOP_MAX];
+    int m_count;
+    Timer m_timer;
+};
+
+#if defined(__MBED__) && MBED_CONF_EVENTS_PRESENT
+/**
+ *  @brief: resumes on the thread that dispatches queue
+ */
+class EpdEventQueueExecutor : public EpdExecutor
+{
+public:
+    EpdEventQueueExecutor(events::EventQueue &queue);
+
+    int Schedule(std::coroutine_handle<> handle, unsigned long delay_ms);
+
+private:
+    static void Resume(void *address);
+
+    events::EventQueue &m_queue;
+};
+#endif
+
+class EpdAsync
+{
+public:
+    EpdAsync(Epd &epd, EpdExecutor &executor);
+
+    /**
+     *  @brief: awaitable pause of ms, see Delay
+     */
+    struct DelayAwaiter
+    {
+        EpdExecutor &executor;
+        unsigned long ms;
+
+        bool await_ready()
+        {
+            return false;
+        }
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            if (executor.Schedule(handle, ms) != 0)
+            {
+                wait_ms(ms);
+                return false;
+            }
+            return true;
+        }
+        void await_resume() {}
+    };
+
+    DelayAwaiter Delay(unsigned long ms);
+    EpdTask WaitUntilIdle(void);
+    EpdTask Init(bool high_direction);
+    EpdTask Display(const unsigned char *frame_buffer);
+    EpdTask DisplayPartBaseImage(const unsigned char *frame_buffer);
+    EpdTask DisplayPart(const unsigned char *frame_buffer);
+    EpdTask Sleep(int mode = SLEEP_MODE_1);
+
+private:
+    EpdTask Refresh(const unsigned char *frame_buffer, bool base, bool partial);
+
+    Epd &m_epd;
+    EpdExecutor &m_executor;
+};
+
+#endif /* C++20 coroutines */
+
+#endif /* EPDASYNC_H */
+
+/* END OF FILE */
@@ -0,0 +1,153 @@
+/**
+ *  @filename   :   epdgroup.cpp
+ *  @brief      :   Implements the panel group
+ */
+
+#include "epdgroup.h"
+
+/* keep the first error */
+static inline void Keep(int *result, int value)
+{
+    if (*result == EPD_OK)
+    {
+        *result = value;
+    }
+}
+
+EpdGroup::EpdGroup(void) : m_count(0)
+{
+}
+
+/**
+ *  @brief: add an initialised panel, returns its index in the frame
+ *          buffer arrays, or -1 if the group is full
+ */
+int EpdGroup::Add(Epd &epd)
+{
+    if (m_count >= EPD_GROUP_MAX)
+    {
+        return -1;
+    }
+    m_epds[m_count] = &epd;
+    return m_count++;
+}
+
+int EpdGroup::GetCount(void)
+{
+    return m_count;
+}
+
+/**
+ *  @brief: full refresh of every panel, frame_buffers holds one frame
+ *          per panel in the order they were added. a NULL frame
+ *          leaves that panel as it is. returns EPD_OK, or the error of
+ *          the first panel that failed; the others still refresh.
+ */
+int EpdGroup::Display(const unsigned char *const *frame_buffers)
+{
+    return Refresh(frame_buffers, false, false);
+}
+
+/**
+ *  @brief: see Epd::DisplayPartBaseImage
+ */
+int EpdGroup::DisplayPartBaseImage(const unsigned char *const *frame_buffers)
+{
+    return Refresh(frame_buffers, true, false);
+}
+
+/**
+ *  @brief: see Epd::DisplayPart
+ */
+int EpdGroup::DisplayPart(const unsigned char *const *frame_buffers)
+{
+    return Refresh(frame_buffers, false, true);
+}
+
+/**
+ *  @brief: true while any panel is still refreshing
+ */
+bool EpdGroup::IsBusy(void)
+{
+    for (int i = 0; i < m_count; i++)
+    {
+        if (m_epds[i]->IsBusy())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *  @brief: wait for every panel, finishing each as soon as its BUSY
+ *          drops or its own refresh timeout is over, so no panel is
+ *          waited for while another one could be finished. returns
+ *          EPD_OK, or the first error.
+ */
+int EpdGroup::WaitUntilIdle(void)
+{
+    int result = EPD_OK;
+    bool pending[EPD_GROUP_MAX];
+    int left = m_count;
+
+    for (int i = 0; i < m_count; i++)
+    {
+        pending[i] = true;
+    }
+    while (left > 0)
+    {
+        for (int i = 0; i < m_count; i++)
+        {
+            Epd *epd = m_epds[i];
+            if (pending[i] && (!epd->IsRefreshing() || !epd->IsBusy() || epd->RefreshTimedOut()))
+            {
+                Keep(&result, epd->AutoRecover(epd->FinishRefresh()));
+                pending[i] = false;
+                left--;
+            }
+        }
+        if (left > 0)
+        {
+            wait_ms(1);
+        }
+    }
+    return result;
+}
+
+/**
+ *  @brief: private function to upload and start each panel in turn,
+ *          then wait for all of them
+ */
+int EpdGroup::Refresh(const unsigned char *const *frame_buffers, bool base, bool partial)
+{
+    int result = EPD_OK;
+
+    for (int i = 0; i < m_count; i++)
+    {
+        if (frame_buffers[i] == NULL)
+        {
+            continue;
+        }
+        /* the panel may still run a refresh of its own. after a
+           recovery the new frame still goes out below */
+        int finished = m_epds[i]->AutoRecover(m_epds[i]->FinishRefresh());
+        if (finished != EPD_RECOVERED)
+        {
+            Keep(&result, finished);
+        }
+        if (base)
+        {
+            m_epds[i]->UploadBaseImage(frame_buffers[i]);
+        }
+        else
+        {
+            m_epds[i]->UploadFrame(frame_buffers[i]);
+        }
+        Keep(&result, m_epds[i]->StartRefresh(partial));
+    }
+    Keep(&result, WaitUntilIdle());
+    return result;
+}
+
+/* END OF FILE */
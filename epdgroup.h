@@ -0,0 +1,41 @@
+/**
+ *  @filename   :   epdgroup.h
+ *  @brief      :   Drives several panels as one. Each panel gets its
+ *                  frame and starts refreshing right away, while the
+ *                  next one is loaded, so the slow refreshes overlap
+ *                  and the whole group takes about one refresh plus
+ *                  the uploads. The panels may share the SPI bus.
+ */
+
+#ifndef EPDGROUP_H
+#define EPDGROUP_H
+
+#include "epd1in54v2.h"
+
+// Most panels in a group
+#define EPD_GROUP_MAX 4
+
+class EpdGroup
+{
+public:
+    EpdGroup(void);
+
+    int Add(Epd &epd);
+    int GetCount(void);
+
+    int Display(const unsigned char *const *frame_buffers);
+    int DisplayPartBaseImage(const unsigned char *const *frame_buffers);
+    int DisplayPart(const unsigned char *const *frame_buffers);
+    bool IsBusy(void);
+    int WaitUntilIdle(void);
+
+private:
+    int Refresh(const unsigned char *const *frame_buffers, bool base, bool partial);
+
+    Epd *m_epds[EPD_GROUP_MAX];
+    int m_count;
+};
+
+#endif /* EPDGROUP_H */
+
+/* END OF FILE */
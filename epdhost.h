@@ -0,0 +1,130 @@
+/**
+ *  @filename   :   epdhost.h
+ *  @brief      :   Stand-ins for the mbed classes the driver uses, for
+ *                  building it on a PC with EPD_HOST_BUILD defined.
+ *                  Time is virtual: it only moves on with delays and
+ *                  SPI transfers, and BUSY is emulated by EpdIf from
+ *                  the commands sent, so timings and the energy figures
+ *                  built on them come out the same on every run.
+ */
+
+#ifndef EPDHOST_H
+#define EPDHOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int PinName;
+#define NC (-1)
+
+/* virtual time in ns */
+extern unsigned long long epd_host_now_ns;
+
+/* a BUSY input, high until busy_until_ns */
+class DigitalIn
+{
+public:
+    DigitalIn(PinName) : busy_until_ns(0) {}
+    operator int()
+    {
+        return epd_host_now_ns < busy_until_ns;
+    }
+
+    unsigned long long busy_until_ns;
+};
+
+class DigitalOut
+{
+public:
+    DigitalOut(PinName) : resets(NULL), m_value(0) {}
+    DigitalOut &operator=(int value)
+    {
+        m_value = value;
+        if (resets != NULL && value == 0)
+        {
+            /* a reset ends whatever the controller was doing */
+            resets->busy_until_ns = 0;
+        }
+        return *this;
+    }
+    operator int()
+    {
+        return m_value;
+    }
+
+    /* the BUSY input a low level on this pin clears, for RST */
+    DigitalIn *resets;
+
+private:
+    int m_value;
+};
+
+class SPI
+{
+public:
+    SPI(PinName, PinName, PinName) : m_hz(1000000) {}
+    void format(int, int = 0) {}
+    void frequency(int hz)
+    {
+        m_hz = hz;
+    }
+    int write(int)
+    {
+        epd_host_now_ns += 8000000000ULL / m_hz;
+        return 0;
+    }
+    int write(const char *, int tx_length, char *, int)
+    {
+        epd_host_now_ns += 8000000000ULL * tx_length / m_hz;
+        return tx_length;
+    }
+    void lock(void) {}
+    void unlock(void) {}
+
+private:
+    int m_hz;
+};
+
+class Timer
+{
+public:
+    Timer() : m_start_ns(0) {}
+    void start(void)
+    {
+        m_start_ns = epd_host_now_ns;
+    }
+    void stop(void) {}
+    void reset(void)
+    {
+        m_start_ns = epd_host_now_ns;
+    }
+    int read_ms(void)
+    {
+        return (epd_host_now_ns - m_start_ns) / 1000000;
+    }
+    unsigned long long read_high_resolution_us(void)
+    {
+        return (epd_host_now_ns - m_start_ns) / 1000;
+    }
+
+private:
+    unsigned long long m_start_ns;
+};
+
+inline void wait_ms(int ms)
+{
+    epd_host_now_ns += ms * 1000000ULL;
+}
+
+inline void core_util_critical_section_enter(void) {}
+inline void core_util_critical_section_exit(void) {}
+
+inline bool core_util_atomic_cas_u8(volatile uint8_t *ptr, uint8_t *expectedCurrentValue, uint8_t desiredValue)
+{
+    return __atomic_compare_exchange_n(ptr, expectedCurrentValue, desiredValue, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif /* EPDHOST_H */
+
+/* END OF FILE */
@@ -26,7 +26,30 @@
  */
 
 #include "epdif.h"
+
+#if defined(EPD_HOST_BUILD)
+unsigned long long epd_host_now_ns = 0;
+
+/* how long the emulated controller keeps BUSY high, in ms */
+#define HOST_SWRESET_MS 2
+#define HOST_POWER_ON_MS 20      /* clock and analog enable */
+#define HOST_TEMPERATURE_MS 20   /* sensor read */
+#define HOST_LUT_LOAD_MS 10      /* waveform from OTP */
+#define HOST_FULL_REFRESH_MS 1800
+#define HOST_PART_REFRESH_MS 300
+#define HOST_POWER_OFF_MS 1
+#endif
 EpdIf::EpdIf(){
+    m_spi = NULL;
+    m_cs = NULL;
+    m_dc = NULL;
+    m_rst = NULL;
+    m_busy = NULL;
+    m_clock = NULL;
+    m_owns_spi = false;
+    m_frequency = EPD_SPI_FREQUENCY;
+    m_spi_mode = 0;
+    m_transaction = 0;
     }
 EpdIf::EpdIf(PinName mosi, 
              PinName miso, 
@@ -36,13 +59,53 @@ EpdIf::EpdIf(PinName mosi,
              PinName rst, 
              PinName busy) {
     m_spi = new SPI(mosi, miso, sclk);
+    m_owns_spi = true;
+    Setup(cs, dc, rst, busy, EPD_SPI_FREQUENCY);
+}
+
+/**
+ *  @brief: on a bus shared with other devices. every transfer locks
+ *          the bus and sets this device's format and frequency first,
+ *          the SPI object stays the caller's.
+ */
+EpdIf::EpdIf(SPI *spi,
+             PinName cs,
+             PinName dc,
+             PinName rst,
+             PinName busy,
+             int frequency) {
+    m_spi = spi;
+    m_owns_spi = false;
+    Setup(cs, dc, rst, busy, frequency);
+}
+
+void EpdIf::Setup(PinName cs, PinName dc, PinName rst, PinName busy, int frequency) {
     m_cs = new DigitalOut(cs);
     m_dc = new DigitalOut(dc);
     m_rst = new DigitalOut(rst);
     m_busy = new DigitalIn(busy);    
+    m_clock = new Timer();
+    m_clock->start();
+    m_frequency = frequency;
+    m_spi_mode = 0;
+    m_transaction = 0;
+    *m_cs = 1;
+#if defined(EPD_HOST_BUILD)
+    m_rst->resets = m_busy;
+    m_host_command = 0;
+    m_host_sequence = 0;
+#endif
 }
 
 EpdIf::~EpdIf() {
+    if (m_owns_spi) {
+        delete m_spi;
+    }
+    delete m_cs;
+    delete m_dc;
+    delete m_rst;
+    delete m_busy;
+    delete m_clock;
 }
 
 void EpdIf::DigitalWrite(DigitalOut* pout, int value) {
@@ -58,16 +121,102 @@ void EpdIf::DelayMs(unsigned int delaytime) {
     wait_ms(delaytime);
 }
 
+/**
+ *  @brief: milliseconds since the interface was created
+ */
+unsigned long EpdIf::GetMs(void) {
+    return m_clock->read_high_resolution_us() / 1000;
+}
+
+/**
+ *  @brief: keep the bus for a whole upload, until the matching
+ *          EndTransaction. they nest.
+ */
+void EpdIf::BeginTransaction(void) {
+    if (m_transaction++ == 0 && !m_owns_spi) {
+        m_spi->lock();
+        m_spi->format(8, m_spi_mode);
+        m_spi->frequency(m_frequency);
+    }
+}
+
+void EpdIf::EndTransaction(void) {
+    if (--m_transaction == 0 && !m_owns_spi) {
+        m_spi->unlock();
+    }
+}
+
 void EpdIf::SpiTransfer(unsigned char data) {
+    BeginTransaction();
     *m_cs = 0;
     m_spi->write(data);
     *m_cs = 1;
+    EndTransaction();
+#if defined(EPD_HOST_BUILD)
+    HostByte(data);
+#endif
+}
+
+/**
+ *  @brief: burst transfer, chip select stays low for all bytes
+ */
+void EpdIf::SpiTransfer(const unsigned char *data, int length) {
+    BeginTransaction();
+    *m_cs = 0;
+    m_spi->write((const char *)data, length, NULL, 0);
+    *m_cs = 1;
+    EndTransaction();
+#if defined(EPD_HOST_BUILD)
+    for (int i = 0; i < length; i++) {
+        HostByte(data[i]);
+    }
+#endif
 }
 
 int EpdIf::IfInit(void){
-    m_spi->format(8,0); 
-    m_spi->frequency(2000000); 
+    if (m_owns_spi) {
+        m_spi->format(8, m_spi_mode); 
+        m_spi->frequency(m_frequency); 
+    }
     return 0;
 }
-    
 
+#if defined(EPD_HOST_BUILD)
+/**
+ *  @brief: follow the commands like the controller would, to raise
+ *          BUSY for as long as the real one takes
+ */
+void EpdIf::HostByte(unsigned char data) {
+    unsigned long ms = 0;
+
+    if (*m_dc != 0) {
+        if (m_host_command == 0x22) {
+            m_host_sequence = data;
+        }
+        return;
+    }
+    m_host_command = data;
+    if (data == 0x12) {
+        ms = HOST_SWRESET_MS;
+    } else if (data == 0x20) {
+        if (m_host_sequence & 0xC0) {
+            ms += HOST_POWER_ON_MS;
+        }
+        if (m_host_sequence & 0x20) {
+            ms += HOST_TEMPERATURE_MS;
+        }
+        if (m_host_sequence & 0x10) {
+            ms += HOST_LUT_LOAD_MS;
+        }
+        if (m_host_sequence & 0x04) {
+            ms += (m_host_sequence & 0x08) ? HOST_PART_REFRESH_MS : HOST_FULL_REFRESH_MS;
+        }
+        if (m_host_sequence & 0x03) {
+            ms += HOST_POWER_OFF_MS;
+        }
+    }
+    if (ms > 0) {
+        m_busy->busy_until_ns = epd_host_now_ns + ms * 1000000ULL;
+    }
+}
+#endif
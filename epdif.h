@@ -27,10 +27,18 @@
 
 #ifndef EPDIF_H
 #define EPDIF_H
+#if defined(EPD_HOST_BUILD)
+#include "epdhost.h"
+#else
 #include "mbed.h"
+#endif
 
 
 #define SPI_
+
+// SPI clock of the panel, also the default on a shared bus
+#define EPD_SPI_FREQUENCY 2000000
+
 class EpdIf {
 public:
     EpdIf(void);
@@ -41,19 +49,44 @@ public:
           PinName dc, 
           PinName rst, 
           PinName busy);
+    EpdIf(SPI* spi,
+          PinName cs,
+          PinName dc,
+          PinName rst,
+          PinName busy,
+          int frequency);
     ~EpdIf(void);
 
     int  IfInit(void);
     static void DigitalWrite(DigitalOut* put, int value); 
     static int  DigitalRead(DigitalIn* pin);
     static void DelayMs(unsigned int delaytime);
+    unsigned long GetMs(void);
     void SpiTransfer(unsigned char data);
+    void SpiTransfer(const unsigned char *data, int length);
+    void BeginTransaction(void);
+    void EndTransaction(void);
     
     SPI* m_spi;
     DigitalOut* m_cs;
     DigitalOut* m_dc;
     DigitalOut* m_rst;
     DigitalIn*  m_busy;
+    Timer* m_clock;
+    bool m_owns_spi;
+    int m_frequency;
+    int m_spi_mode;
+    int m_transaction;
+
+private:
+    void Setup(PinName cs, PinName dc, PinName rst, PinName busy, int frequency);
+
+#if defined(EPD_HOST_BUILD)
+    /* emulated controller, for the BUSY timing */
+    unsigned char m_host_command;
+    unsigned char m_host_sequence;
+    void HostByte(unsigned char data);
+#endif
 };
 
 #endif
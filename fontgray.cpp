@@ -0,0 +1,81 @@
+/**
+ *  @filename   :   fontgray.cpp
+ *  @brief      :   Derives anti-aliased fonts from the regular fonts
+ */
+
+#include <string.h>
+#include "fontgray.h"
+
+size_t GrayFontSize(const sFONT *font, int bits)
+{
+    int width = (font->Width + 1) / 2;
+    int height = (font->Height + 1) / 2;
+    return (size_t)FONT_GLYPH_COUNT * height * ((width * bits + 7) / 8);
+}
+
+/**
+ *  @brief: fill table with a half size copy of font, each pixel holding
+ *          the coverage of a 2x2 block. bits must be 2 or 4.
+ *          returns 0 on success, -1 if table is too small.
+ */
+int BuildGrayFont(const sFONT *font, int bits, uint8_t *table, size_t size, sFONTGRAY *gray_font)
+{
+    int src_bytes = font->Width / 8 + (font->Width % 8 ? 1 : 0);
+    int width = (font->Width + 1) / 2;
+    int height = (font->Height + 1) / 2;
+    int dst_bytes = (width * bits + 7) / 8;
+    int max_level = (1 << bits) - 1;
+
+    if ((bits != 2 && bits != 4) || size < GrayFontSize(font, bits))
+    {
+        return -1;
+    }
+    memset(table, 0, GrayFontSize(font, bits));
+
+    for (int glyph = 0; glyph < FONT_GLYPH_COUNT; glyph++)
+    {
+        int index = glyph;
+        if (font->map != NULL)
+        {
+            /* a FontSubset, glyphs it doesn't have stay blank */
+            if (font->map[glyph] == FONT_NO_GLYPH)
+            {
+                continue;
+            }
+            index = font->map[glyph];
+        }
+        const uint8_t *src = &font->table[index * font->Height * src_bytes];
+        uint8_t *dst = &table[glyph * height * dst_bytes];
+
+        for (int j = 0; j < height; j++)
+        {
+            for (int i = 0; i < width; i++)
+            {
+                int covered = 0;
+                for (int dy = 0; dy < 2; dy++)
+                {
+                    for (int dx = 0; dx < 2; dx++)
+                    {
+                        int sx = 2 * i + dx;
+                        int sy = 2 * j + dy;
+                        if (sx < font->Width && sy < font->Height &&
+                            (src[sy * src_bytes + sx / 8] & (0x80 >> (sx % 8))))
+                        {
+                            covered++;
+                        }
+                    }
+                }
+                /* 0..4 covered pixels to 0..max_level, rounded */
+                int level = (covered * max_level + 2) / 4;
+                int bit = i * bits;
+                dst[j * dst_bytes + bit / 8] |= level << (8 - bits - bit % 8);
+            }
+        }
+    }
+
+    gray_font->table = table;
+    gray_font->Width = width;
+    gray_font->Height = height;
+    gray_font->Bits = bits;
+    return 0;
+}
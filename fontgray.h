@@ -0,0 +1,37 @@
+/**
+ *  @filename   :   fontgray.h
+ *  @brief      :   Anti-aliased fonts with 2 or 4 bit coverage per pixel.
+ *                  Epd::DrawGrayCharAt renders them into a frame buffer
+ *                  through an ordered dither, Epd::DrawGrayBufferCharAt
+ *                  blends them into a gray buffer for DisplayGray.
+ *                  BuildGrayFont derives one from the regular fonts,
+ *                  FontSubset ones too, by averaging 2x2 pixel blocks,
+ *                  e.g. a 9x12 anti-aliased font from Font24.
+ */
+
+#ifndef FONTGRAY_H
+#define FONTGRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fonts.h"
+
+typedef struct _tFontGray
+{
+  /* FONT_GLYPH_COUNT glyphs from FONT_FIRST_CHAR, Bits per pixel msb
+     first, each row padded to whole bytes. 0 is background, the
+     largest value full ink */
+  const uint8_t *table;
+  uint16_t Width;
+  uint16_t Height;
+  uint8_t Bits;
+
+} sFONTGRAY;
+
+/* bytes of table needed by BuildGrayFont for a font */
+size_t GrayFontSize(const sFONT *font, int bits);
+int BuildGrayFont(const sFONT *font, int bits, uint8_t *table, size_t size, sFONTGRAY *gray_font);
+
+#endif /* FONTGRAY_H */
+
+/* END OF FILE */
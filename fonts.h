@@ -44,11 +44,17 @@
 #define MAX_WIDTH_FONT          17
 #define OFFSET_BITMAP           54
 
+/* Glyphs cover the printable ASCII range ' '..'~' */
+#define FONT_FIRST_CHAR         ' '
+#define FONT_GLYPH_COUNT        95
+#define FONT_NO_GLYPH           0xFF
+
 #ifdef __cplusplus
  extern "C" {
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct _tFont
@@ -56,6 +62,9 @@ typedef struct _tFont
   const uint8_t *table;
   uint16_t Width;
   uint16_t Height;
+  /* Glyph index per character (FONT_NO_GLYPH if absent), NULL when the
+     table holds all FONT_GLYPH_COUNT glyphs, see fontsubset.h */
+  const uint8_t *map;
   
 } sFONT;
 
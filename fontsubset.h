@@ -0,0 +1,182 @@
+/**
+ *  @filename   :   fontsubset.h
+ *  @brief      :   Compile-time font subsetting.
+ *                  A FontSubset only links the glyphs of the characters
+ *                  it is instantiated with, plus a FONT_GLYPH_COUNT byte
+ *                  remap table, instead of the whole font table.
+ *
+ *                  typedef FontSubset<Font24Source, '0', '1', '2', '3', '4',
+ *                                     '5', '6', '7', '8', '9', ':'> Clock24;
+ *                  sFONT ClockFont = Clock24::Font();
+ *                  epd.DrawStringAt(frame, 0, 0, "12:34", &ClockFont, COLORED);
+ *
+ *                  Characters that are not part of the subset are skipped
+ *                  by DrawCharAt. The tables are linked once, however
+ *                  many translation units use the same subset.
+ *                  Requires C++14.
+ */
+
+#ifndef FONTSUBSET_H
+#define FONTSUBSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "fonts.h"
+
+namespace fontsubset
+{
+
+/* the font tables as constant expressions. static members of a class
+   template have external linkage, so a build keeps one copy of a table
+   however many units use it, not one per unit. */
+template <typename Unused = void>
+struct Glyphs
+{
+    static constexpr uint8_t font8[] = {
+#include "font8_table.inc"
+    };
+    static constexpr uint8_t font12[] = {
+#include "font12_table.inc"
+    };
+    static constexpr uint8_t font16[] = {
+#include "font16_table.inc"
+    };
+    static constexpr uint8_t font20[] = {
+#include "font20_table.inc"
+    };
+    static constexpr uint8_t font24[] = {
+#include "font24_table.inc"
+    };
+};
+
+template <typename Unused>
+constexpr uint8_t Glyphs<Unused>::font8[];
+template <typename Unused>
+constexpr uint8_t Glyphs<Unused>::font12[];
+template <typename Unused>
+constexpr uint8_t Glyphs<Unused>::font16[];
+template <typename Unused>
+constexpr uint8_t Glyphs<Unused>::font20[];
+template <typename Unused>
+constexpr uint8_t Glyphs<Unused>::font24[];
+
+template <char... Chars>
+struct CharList
+{
+};
+
+template <typename Source, typename Chars, typename TableIndices, typename MapIndices>
+struct SubsetTables;
+
+template <typename Source, char... Chars, size_t... TableIndices, size_t... MapIndices>
+struct SubsetTables<Source, CharList<Chars...>,
+                    std::index_sequence<TableIndices...>,
+                    std::index_sequence<MapIndices...> >
+{
+    static constexpr char CharAt(size_t index)
+    {
+        constexpr char chars[] = {Chars...};
+        return chars[index];
+    }
+
+    static constexpr uint8_t TableByte(size_t index)
+    {
+        return Source::table[(CharAt(index / Source::GlyphBytes) - FONT_FIRST_CHAR) * Source::GlyphBytes +
+                             index % Source::GlyphBytes];
+    }
+
+    static constexpr uint8_t MapEntry(size_t glyph)
+    {
+        for (size_t i = 0; i < sizeof...(Chars); i++)
+        {
+            if (CharAt(i) - FONT_FIRST_CHAR == (int)glyph)
+            {
+                return (uint8_t)i;
+            }
+        }
+        return FONT_NO_GLYPH;
+    }
+
+    static constexpr bool Valid(void)
+    {
+        for (size_t i = 0; i < sizeof...(Chars); i++)
+        {
+            if (CharAt(i) < FONT_FIRST_CHAR || CharAt(i) >= FONT_FIRST_CHAR + FONT_GLYPH_COUNT)
+            {
+                return false;
+            }
+            for (size_t j = 0; j < i; j++)
+            {
+                if (CharAt(i) == CharAt(j))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static constexpr uint8_t table[] = {TableByte(TableIndices)...};
+    static constexpr uint8_t map[] = {MapEntry(MapIndices)...};
+};
+
+template <typename Source, char... Chars, size_t... TableIndices, size_t... MapIndices>
+constexpr uint8_t SubsetTables<Source, CharList<Chars...>,
+                               std::index_sequence<TableIndices...>,
+                               std::index_sequence<MapIndices...> >::table[];
+
+template <typename Source, char... Chars, size_t... TableIndices, size_t... MapIndices>
+constexpr uint8_t SubsetTables<Source, CharList<Chars...>,
+                               std::index_sequence<TableIndices...>,
+                               std::index_sequence<MapIndices...> >::map[];
+
+} // namespace fontsubset
+
+/**
+ *  @brief: describes one of the fonts of fonts.h to FontSubset
+ */
+template <const uint8_t *Table, uint16_t FontWidth, uint16_t FontHeight>
+struct FontSource
+{
+    static constexpr const uint8_t *table = Table;
+    static constexpr uint16_t Width = FontWidth;
+    static constexpr uint16_t Height = FontHeight;
+    static constexpr size_t GlyphBytes = FontHeight * (FontWidth / 8 + (FontWidth % 8 ? 1 : 0));
+};
+
+typedef FontSource<fontsubset::Glyphs<>::font8, 5, 8> Font8Source;
+typedef FontSource<fontsubset::Glyphs<>::font12, 7, 12> Font12Source;
+typedef FontSource<fontsubset::Glyphs<>::font16, 11, 16> Font16Source;
+typedef FontSource<fontsubset::Glyphs<>::font20, 14, 20> Font20Source;
+typedef FontSource<fontsubset::Glyphs<>::font24, 17, 24> Font24Source;
+
+/**
+ *  @brief: a font holding only the glyphs of Chars, in that order
+ */
+template <typename Source, char... Chars>
+class FontSubset
+{
+    typedef fontsubset::SubsetTables<Source, fontsubset::CharList<Chars...>,
+                                     std::make_index_sequence<sizeof...(Chars) * Source::GlyphBytes>,
+                                     std::make_index_sequence<FONT_GLYPH_COUNT> >
+        Tables;
+
+    static_assert(sizeof...(Chars) > 0, "a font subset needs at least one character");
+    static_assert(sizeof...(Chars) < FONT_NO_GLYPH, "too many characters for a font subset");
+    static_assert(Tables::Valid(), "font subset characters must be printable ASCII and unique");
+
+public:
+    static constexpr size_t GlyphCount = sizeof...(Chars);
+    static constexpr size_t TableSize = sizeof...(Chars) * Source::GlyphBytes;
+
+    static sFONT Font(void)
+    {
+        sFONT font = {Tables::table, Source::Width, Source::Height, Tables::map};
+        return font;
+    }
+};
+
+#endif /* FONTSUBSET_H */
+
+/* END OF FILE */
@@ -0,0 +1,165 @@
+/**
+ *  @filename   :   framebuffers.h
+ *  @brief      :   Two or three frame buffers in static storage. The
+ *                  application draws into the back buffer and Submit
+ *                  swaps it with the front one by pointer, nothing is
+ *                  copied. The front buffer is locked while it is sent
+ *                  to the panel; with three buffers a Submit then goes
+ *                  to the spare one and becomes the front at unlock,
+ *                  with two it has to be tried again later.
+ *
+ *                  The Epd remembers the front buffer for Recover,
+ *                  but after the next Submit the application draws
+ *                  into it again. With SetAutoRecover or Recover, give
+ *                  the Epd a copy of the shown frame with
+ *                  SetRecoveryFrame, as RefreshPolicy does with its
+ *                  shadow buffer.
+ */
+
+#ifndef FRAMEBUFFERS_H
+#define FRAMEBUFFERS_H
+
+#include <string.h>
+#include "epd1in54v2.h"
+
+template <int N>
+class FrameBuffers
+{
+public:
+    FrameBuffers(void) : m_front(m_frames[0]),
+                         m_back(m_frames[1]),
+                         m_spare(N > 2 ? m_frames[N - 1] : NULL),
+                         m_locked(false),
+                         m_pending(false)
+    {
+        /* only 2 or 3 buffers */
+        typedef char buffer_count_check[(N == 2 || N == 3) ? 1 : -1];
+        (void)sizeof(buffer_count_check);
+        memset(m_frames, 0xFF, sizeof(m_frames));
+    }
+
+    /**
+     *  @brief: the buffer to draw into. it holds an older frame, not
+     *          the one submitted last.
+     */
+    unsigned char *GetBackBuffer(void)
+    {
+        return m_back;
+    }
+
+    /**
+     *  @brief: the last submitted frame shown or being shown
+     */
+    const unsigned char *GetFrontBuffer(void)
+    {
+        return m_front;
+    }
+
+    /**
+     *  @brief: make the back buffer the front one. returns 0, or -1
+     *          if the front is locked and there is no spare buffer.
+     */
+    int Submit(void)
+    {
+        int result = 0;
+        unsigned char *swap;
+
+        core_util_critical_section_enter();
+        if (!m_locked)
+        {
+            swap = m_front;
+            m_front = m_back;
+            m_back = swap;
+        }
+        else if (m_spare != NULL)
+        {
+            /* a frame pending before is dropped for the newer one */
+            swap = m_spare;
+            m_spare = m_back;
+            m_back = swap;
+            m_pending = true;
+        }
+        else
+        {
+            result = -1;
+        }
+        core_util_critical_section_exit();
+        return result;
+    }
+
+    bool IsLocked(void)
+    {
+        return m_locked;
+    }
+
+    /**
+     *  @brief: keep the front buffer from being swapped out while it
+     *          is read, pair with UnlockFront
+     */
+    const unsigned char *LockFront(void)
+    {
+        core_util_critical_section_enter();
+        m_locked = true;
+        const unsigned char *front = m_front;
+        core_util_critical_section_exit();
+        return front;
+    }
+
+    /**
+     *  @brief: a frame submitted while locked becomes the front now
+     */
+    void UnlockFront(void)
+    {
+        unsigned char *swap;
+
+        core_util_critical_section_enter();
+        m_locked = false;
+        if (m_pending)
+        {
+            swap = m_front;
+            m_front = m_spare;
+            m_spare = swap;
+            m_pending = false;
+        }
+        core_util_critical_section_exit();
+    }
+
+    /**
+     *  @brief: show the front buffer, locked only while it is uploaded,
+     *          not during the refresh. returns the result of the
+     *          refresh, see Epd::DisplayFrame.
+     */
+    int Display(Epd &epd)
+    {
+        epd.UploadFrame(LockFront());
+        UnlockFront();
+        return epd.DisplayFrame();
+    }
+
+    int DisplayPartBaseImage(Epd &epd)
+    {
+        epd.UploadBaseImage(LockFront());
+        UnlockFront();
+        return epd.DisplayFrame();
+    }
+
+    int DisplayPart(Epd &epd)
+    {
+        epd.UploadFrame(LockFront());
+        UnlockFront();
+        return epd.DisplayPartFrame();
+    }
+
+private:
+    unsigned char m_frames[N][EPD_BUFFER_SIZE];
+    unsigned char *m_front;
+    unsigned char *m_back;
+    unsigned char *m_spare;
+    volatile bool m_locked;
+    /* m_spare holds a frame submitted while locked */
+    volatile bool m_pending;
+};
+
+#endif /* FRAMEBUFFERS_H */
+
+/* END OF FILE */
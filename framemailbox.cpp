@@ -0,0 +1,104 @@
+/**
+ *  @filename   :   framemailbox.cpp
+ *  @brief      :   Implements the frame mailbox
+ */
+
+#include <string.h>
+#include "framemailbox.h"
+
+// Flags next to the buffer index in m_middle
+#define MAILBOX_INDEX 0x03
+#define MAILBOX_FRESH 0x04 /* published, not taken yet */
+#define MAILBOX_FULL 0x08  /* needs a full refresh */
+
+FrameMailbox::FrameMailbox(void) : m_middle(1),
+                                   m_back(0),
+                                   m_front(2),
+                                   m_dropped(0)
+{
+    memset(m_frames, 0xFF, sizeof(m_frames));
+}
+
+/**
+ *  @brief: the buffer to draw the next frame into. it changes with
+ *          every Publish and holds an older frame, not the last one.
+ */
+unsigned char *FrameMailbox::GetBackBuffer(void)
+{
+    return m_frames[m_back];
+}
+
+/**
+ *  @brief: hand the back buffer over. a full refresh that wasn't
+ *          taken yet stays full even if the frame replacing it is
+ *          partial, so the panel is not left ghosted.
+ */
+void FrameMailbox::Publish(bool partial)
+{
+    uint8_t old = m_middle;
+    uint8_t next;
+
+    do
+    {
+        next = m_back | MAILBOX_FRESH;
+        if (!partial || (old & (MAILBOX_FRESH | MAILBOX_FULL)) == (MAILBOX_FRESH | MAILBOX_FULL))
+        {
+            next |= MAILBOX_FULL;
+        }
+    } while (!core_util_atomic_cas_u8(&m_middle, &old, next));
+
+    if (old & MAILBOX_FRESH)
+    {
+        m_dropped = m_dropped + 1;
+    }
+    m_back = old & MAILBOX_INDEX;
+}
+
+/**
+ *  @brief: copy frame_buffer into the back buffer and publish it
+ */
+void FrameMailbox::Post(const unsigned char *frame_buffer, bool partial)
+{
+    memcpy(m_frames[m_back], frame_buffer, EPD_BUFFER_SIZE);
+    Publish(partial);
+}
+
+/**
+ *  @brief: frames replaced before the consumer took them
+ */
+unsigned long FrameMailbox::GetDropped(void)
+{
+    return m_dropped;
+}
+
+bool FrameMailbox::HasFrame(void)
+{
+    return (m_middle & MAILBOX_FRESH) != 0;
+}
+
+/**
+ *  @brief: the newest published frame, or NULL if there is none since
+ *          the last Take. it stays valid until the next Take. partial
+ *          is set false if the frame needs a full refresh.
+ */
+const unsigned char *FrameMailbox::Take(bool *partial)
+{
+    uint8_t old = m_middle;
+
+    do
+    {
+        if (!(old & MAILBOX_FRESH))
+        {
+            return NULL;
+        }
+    } while (!core_util_atomic_cas_u8(&m_middle, &old, m_front));
+
+    m_front = old & MAILBOX_INDEX;
+    if (partial != NULL)
+    {
+        *partial = !(old & MAILBOX_FULL);
+    }
+    return m_frames[m_front];
+}
+
+/* END OF FILE */
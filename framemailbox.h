@@ -0,0 +1,42 @@
+/**
+ *  @filename   :   framemailbox.h
+ *  @brief      :   Hands frames from one producer to one consumer
+ *                  without locks, through three buffers: the producer
+ *                  draws into the back one, the consumer shows the
+ *                  front one, and publishing swaps the back with the
+ *                  one in the middle. The producer never waits, a
+ *                  frame not taken yet is replaced by the newer one.
+ */
+
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include "epd1in54v2.h"
+
+class FrameMailbox
+{
+public:
+    FrameMailbox(void);
+
+    /* producer side */
+    unsigned char *GetBackBuffer(void);
+    void Publish(bool partial);
+    void Post(const unsigned char *frame_buffer, bool partial);
+    unsigned long GetDropped(void);
+
+    /* consumer side */
+    bool HasFrame(void);
+    const unsigned char *Take(bool *partial);
+
+private:
+    unsigned char m_frames[3][EPD_BUFFER_SIZE];
+    /* buffer index of the middle, with the MAILBOX_ flags */
+    volatile uint8_t m_middle;
+    uint8_t m_back;
+    uint8_t m_front;
+    volatile unsigned long m_dropped;
+};
+
+#endif /* FRAMEMAILBOX_H */
+
+/* END OF FILE */
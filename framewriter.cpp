@@ -0,0 +1,142 @@
+/**
+ *  @filename   :   framewriter.cpp
+ *  @brief      :   Implements streaming of images into the display RAM
+ */
+
+#include <string.h>
+#include "framewriter.h"
+
+/**
+ *  @brief: start writing a width x height image at x, y. rows are
+ *          passed from the top, or from the bottom if bottom_up.
+ */
+FrameMemoryWriter::FrameMemoryWriter(Epd &epd, int x, int y, int width, int height, bool bottom_up) : m_epd(epd),
+                                                                                                    m_x(x),
+                                                                                                    m_y(y),
+                                                                                                    m_width(width),
+                                                                                                    m_height(height),
+                                                                                                    m_bottom_up(bottom_up),
+                                                                                                    m_ended(false),
+                                                                                                    m_rows(0),
+                                                                                                    m_column(-1)
+{
+    m_visible = epd.MapRect(x, y, width, height, &m_px, &m_py, &m_pw, &m_ph);
+    if (!m_visible)
+    {
+        return;
+    }
+    /* whole RAM bytes */
+    m_pw = (m_px + m_pw + 7) / 8 * 8 - m_px / 8 * 8;
+    m_px = m_px / 8 * 8;
+
+    if (epd.rotate == ROTATE_0 || epd.rotate == ROTATE_180)
+    {
+        /* rows of the image are frame buffer rows, one window for all */
+        bool reversed = (epd.rotate == ROTATE_180) != bottom_up;
+        epd.SetRamWindow(m_px, m_px + m_pw - 1,
+                         reversed ? m_py + m_ph - 1 : m_py,
+                         reversed ? m_py : m_py + m_ph - 1);
+        epd.SendCommand(WRITE_RAM);
+    }
+}
+
+FrameMemoryWriter::~FrameMemoryWriter()
+{
+    End();
+}
+
+/**
+ *  @brief: write the next row of width pixels
+ */
+void FrameMemoryWriter::WriteRow(const unsigned char *row)
+{
+    int j = m_bottom_up ? m_height - 1 - m_rows : m_rows;
+    int y = m_y + j;
+
+    m_rows++;
+    if (!m_visible || m_ended || y < 0 || y >= (int)m_epd.height)
+    {
+        return;
+    }
+
+    int x0 = m_x < 0 ? -m_x : 0;
+    int x1 = m_x + m_width > (int)m_epd.width ? (int)m_epd.width - m_x : m_width;
+    int px, py;
+
+    if (m_epd.rotate == ROTATE_0 || m_epd.rotate == ROTATE_180)
+    {
+        m_epd.MapPoint(m_x + x0, y, &px, &py);
+        if (py < m_py || py >= m_py + m_ph)
+        {
+            return;
+        }
+        memset(m_buffer, 0xFF, m_pw / 8);
+        for (int i = x0; i < x1; i++)
+        {
+            m_epd.MapPoint(m_x + i, y, &px, &py);
+            if (px >= m_px && px < m_px + m_pw && !(row[i / 8] & (0x80 >> (i % 8))))
+            {
+                m_buffer[(px - m_px) / 8] &= ~(0x80 >> (px % 8));
+            }
+        }
+        m_epd.SendData(m_buffer, m_pw / 8);
+        return;
+    }
+
+    /* a row of the image is a frame buffer column, collect 8 of them */
+    m_epd.MapPoint(m_x + x0, y, &px, &py);
+    if (px < 0 || px >= EPD_WIDTH)
+    {
+        return;
+    }
+    if (px / 8 != m_column)
+    {
+        Flush();
+        m_column = px / 8;
+        memset(m_buffer, 0xFF, sizeof(m_buffer));
+    }
+    for (int i = x0; i < x1; i++)
+    {
+        m_epd.MapPoint(m_x + i, y, &px, &py);
+        if (py >= m_py && py < m_py + m_ph && !(row[i / 8] & (0x80 >> (i % 8))))
+        {
+            m_buffer[py] &= ~(0x80 >> (px % 8));
+        }
+    }
+}
+
+/**
+ *  @brief: write what is still collected and give the RAM window
+ *          back to the whole display. call before DisplayFrame.
+ */
+void FrameMemoryWriter::End(void)
+{
+    if (m_ended)
+    {
+        return;
+    }
+    m_ended = true;
+    if (!m_visible)
+    {
+        return;
+    }
+    Flush();
+    m_epd.SetRamWindow(0, EPD_WIDTH - 1, 0, EPD_HEIGHT - 1);
+}
+
+/**
+ *  @brief: private function to write the collected byte column
+ */
+void FrameMemoryWriter::Flush(void)
+{
+    if (m_column < 0)
+    {
+        return;
+    }
+    m_epd.BeginTransaction();
+    m_epd.SetRamWindow(m_column * 8, m_column * 8 + 7, m_py, m_py + m_ph - 1);
+    m_epd.SendCommand(WRITE_RAM);
+    m_epd.SendData(&m_buffer[m_py], m_ph);
+    m_epd.EndTransaction();
+    m_column = -1;
+}
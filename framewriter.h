@@ -0,0 +1,57 @@
+/**
+ *  @filename   :   framewriter.h
+ *  @brief      :   Streams an image into the display RAM row by row,
+ *                  placed and rotated like the drawing functions, without
+ *                  a frame buffer. Rows are in frame buffer format (0 is
+ *                  black, msb first). Display RAM can only be written a
+ *                  byte at a time, so pixels that share a RAM byte with
+ *                  the image but lie outside of it are written white.
+ *                  On rotated displays 8 rows are collected for every
+ *                  column of RAM bytes.
+ *
+ *                  FrameMemoryWriter writer(epd, x, y, width, height, false);
+ *                  for (int j = 0; j < height; j++)
+ *                      writer.WriteRow(row_j);
+ *                  writer.End();
+ *                  epd.DisplayFrame();
+ */
+
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include "epd1in54v2.h"
+
+class FrameMemoryWriter
+{
+public:
+    FrameMemoryWriter(Epd &epd, int x, int y, int width, int height, bool bottom_up);
+    ~FrameMemoryWriter();
+
+    void WriteRow(const unsigned char *row);
+    void End(void);
+
+private:
+    void Flush(void);
+
+    Epd &m_epd;
+    int m_x;
+    int m_y;
+    int m_width;
+    int m_height;
+    bool m_bottom_up;
+    bool m_visible;
+    bool m_ended;
+    int m_rows;
+    /* visible part of the image in frame buffer coordinates */
+    int m_px;
+    int m_py;
+    int m_pw;
+    int m_ph;
+    /* frame buffer byte column collected on rotated displays */
+    int m_column;
+    unsigned char m_buffer[EPD_HEIGHT > EPD_WIDTH / 8 ? EPD_HEIGHT : EPD_WIDTH / 8];
+};
+
+#endif /* FRAMEWRITER_H */
+
+/* END OF FILE */
@@ -341,3 +341,152 @@ const unsigned char IMAGE_DATA[] = {
 0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0X8F,0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0XF1,
 0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,0XFF,
 };
+
+/* IMAGE_DATA packed with IMAGE_PACK_ROW_DELTA, see imagepack.h */
+const unsigned char IMAGE_DATA_PACKED[] = {
+0X01,0XC8,0X00,0XC8,0X00,0XF9,0XFF,0X00,0X8F,0XFA,0XFF,0X00,0XF1,0XF9,0XFF,0XBE,
+0X00,0X01,0X01,0XFE,0XEA,0X00,0X02,0X06,0X01,0X80,0XFB,0X00,0X02,0X08,0X00,0XC0,
+0XF4,0X00,0X02,0X08,0X00,0X40,0XFB,0X00,0X02,0X16,0X01,0X20,0XF2,0X00,0X00,0X20,
+0XFB,0X00,0X01,0X02,0X01,0XF3,0X00,0X00,0X10,0XF7,0X00,0X00,0X80,0XF4,0X00,0X02,
+0X01,0XE3,0X1F,0XFE,0XFF,0X00,0XFE,0XFF,0X00,0X02,0X04,0X00,0X10,0XF4,0X00,0X02,
+0X22,0X10,0X0F,0XFE,0XFF,0X01,0XFD,0X00,0X01,0X00,0X04,0XF1,0X00,0X00,0XC8,0XFD,
+0X00,0X00,0X02,0XFD,0X00,0X00,0X90,0XF3,0X00,0X00,0X34,0XFA,0X00,0X01,0X02,0X01,
+0XEA,0X00,0X01,0X11,0X02,0XFA,0X00,0X00,0X1C,0XFA,0X00,0X00,0X88,0XF9,0X00,0X01,
+0XFC,0X20,0XFB,0X00,0X01,0X03,0X80,0XFC,0X00,0X01,0X02,0X84,0XFA,0X00,0X02,0X08,
+0X00,0X40,0XFA,0X00,0X00,0X70,0XFC,0X00,0X02,0X21,0X03,0X10,0XFB,0X00,0X02,0X06,
+0X01,0X80,0XFB,0X00,0X01,0X1C,0X0C,0XF3,0X00,0X01,0X01,0XFE,0XFA,0X00,0X02,0X03,
+0X83,0X80,0XFD,0X00,0X02,0X10,0X00,0X20,0XFE,0X00,0X00,0X80,0XFF,0X00,0X00,0X04,
+0XF8,0X00,0X01,0X70,0X60,0XFD,0X00,0X02,0X08,0X00,0X40,0XFF,0X00,0X01,0X03,0X40,
+0XFF,0X00,0X00,0X1B,0XF8,0X00,0X00,0XF0,0XFC,0X00,0X02,0X06,0X00,0X80,0XFF,0X00,
+0X00,0X0C,0XFF,0X00,0X02,0X00,0X26,0X80,0XFA,0X00,0XFF,0X07,0X00,0X90,0XFC,0X00,
+0X00,0X87,0XFE,0X00,0X01,0X10,0XF0,0XFF,0X00,0X00,0X08,0XF9,0X00,0XFF,0X18,0X02,
+0X00,0X3F,0XF8,0XFE,0X00,0X00,0X78,0XFE,0X00,0X01,0X61,0X48,0XF5,0X00,0X00,0XE0,
+0XFF,0X40,0XF9,0X00,0X01,0X83,0X80,0XFF,0X00,0X00,0X08,0XF9,0X00,0X03,0X03,0X00,
+0X20,0X80,0XFA,0X00,0X02,0X01,0X0E,0X04,0XFF,0X00,0X01,0X26,0X80,0XFA,0X00,0X04,
+0X1C,0X00,0X10,0X1F,0XF8,0XFA,0X00,0X00,0X14,0XFE,0X00,0X00,0X1B,0XED,0X00,0X01,
+0X38,0X02,0XFF,0X00,0X00,0X04,0XF9,0X00,0X01,0X01,0XFE,0XF7,0X00,0X01,0XE0,0X02,
+0XFE,0X00,0X00,0XFC,0XFA,0X00,0X00,0X0E,0XFF,0X00,0X00,0X80,0XFA,0X00,0X01,0X01,
+0XC0,0XFE,0X00,0X02,0X07,0X03,0X80,0XFB,0X00,0X01,0X10,0X00,0XFF,0X1F,0X00,0XF0,
+0XF6,0X00,0X04,0X08,0X00,0X40,0X00,0X18,0XFC,0X00,0X03,0X02,0X00,0X80,0X08,0XFA,
+0X00,0X02,0X80,0X04,0X00,0X05,0X00,0X10,0XCC,0X20,0X00,0X07,0XFD,0X00,0X01,0X02,
+0X72,0XF7,0X00,0X01,0X40,0X08,0XFF,0X00,0X01,0X03,0X0B,0XFE,0X00,0X00,0XC0,0XFE,
+0X00,0X01,0X05,0X48,0XFF,0X00,0X00,0X08,0XF6,0X00,0X05,0X04,0X20,0X90,0X00,0X10,
+0X38,0XFD,0X00,0X03,0X01,0X1F,0XFF,0XF0,0XFA,0X00,0X01,0XC0,0X10,0XFB,0X00,0X01,
+0X0E,0X06,0XFE,0X00,0X01,0X04,0X28,0XF8,0X00,0X02,0X03,0X00,0X20,0XFF,0X00,0X01,
+0X04,0X20,0XFF,0X00,0X02,0X01,0XC1,0X80,0XFE,0X00,0X03,0X11,0X00,0XE0,0X38,0XFD,
+0X00,0X04,0X7C,0X00,0X0C,0X00,0X40,0XFF,0X00,0X02,0X03,0XC0,0X90,0XFF,0X00,0X01,
+0X38,0X40,0XFF,0X00,0X01,0X10,0X80,0XFB,0X00,0X05,0X03,0X82,0X00,0X10,0X00,0X80,
+0XFF,0X00,0X01,0X10,0X08,0XFE,0X00,0X01,0X38,0X20,0XFF,0X00,0X01,0X0C,0X46,0XFB,
+0X00,0X04,0X0C,0X06,0X00,0X60,0X01,0XFE,0X00,0X06,0X08,0X10,0XA0,0X00,0X01,0XC0,
+0X10,0XFE,0X00,0X03,0X38,0X07,0X1F,0XC0,0XFE,0X00,0X04,0X30,0X1F,0X01,0X80,0X02,
+0XFE,0X00,0X06,0X07,0XE0,0X40,0X00,0X0E,0X07,0X88,0XFB,0X00,0X00,0X08,0XFD,0X00,
+0X03,0XF8,0X06,0X00,0X0C,0XFA,0X00,0X02,0X10,0X18,0X40,0XF7,0X00,0X04,0X07,0XE0,
+0X18,0X00,0X10,0XFF,0X00,0XFE,0X00,0X00,0X60,0XFF,0X00,0X00,0XE0,0XFF,0X00,0X05,
+0X01,0XFF,0XFE,0X07,0X1E,0XF0,0XFE,0X00,0X04,0X1B,0X00,0X20,0X00,0X20,0XFE,0X00,
+0X04,0X07,0XC0,0X80,0X00,0X03,0XFA,0X00,0X00,0X01,0XFD,0X00,0X04,0X3C,0X00,0XC0,
+0X00,0XC0,0XFE,0X00,0X01,0X08,0X30,0XFF,0X00,0X00,0X1C,0XFA,0X00,0X00,0XE0,0XFD,
+0X00,0X00,0X20,0XFF,0X00,0X00,0X03,0XFD,0X00,0X01,0X10,0X0C,0XFD,0X00,0X00,0X38,
+0XFF,0X00,0X03,0X03,0XFE,0X07,0X80,0XFD,0X00,0X00,0X20,0XFF,0X00,0X00,0X04,0XFD,
+0X00,0X02,0X03,0XC2,0X80,0XFC,0X00,0X04,0X01,0XC3,0X80,0X00,0X60,0XFA,0X00,0X00,
+0X18,0XFD,0X00,0X01,0X04,0X21,0XFF,0X00,0X01,0X07,0XFF,0XFE,0X00,0X03,0X38,0X60,
+0X00,0X18,0XFD,0X00,0X00,0X10,0XFF,0X00,0X00,0XE0,0XFC,0X00,0X03,0X18,0X80,0X00,
+0X08,0XFD,0X00,0X03,0X06,0X1C,0X00,0X06,0XFD,0X00,0X02,0X08,0X00,0X03,0XFB,0X00,
+0X00,0X04,0XFF,0X00,0X00,0X10,0XFD,0X00,0X04,0X01,0X80,0X00,0XC1,0X80,0XFE,0X00,
+0X02,0X04,0X00,0X3C,0XFC,0X00,0X01,0X04,0X02,0XFA,0X00,0X04,0X03,0X84,0X00,0X30,
+0X60,0XFE,0X00,0X02,0X03,0XB7,0XC0,0XFC,0X00,0X01,0X12,0X01,0XFF,0X00,0X01,0X03,
+0X31,0XFE,0X00,0X04,0X1C,0X38,0X00,0X0C,0X18,0XFD,0X00,0X00,0X48,0XFC,0X00,0X03,
+0X00,0X02,0X00,0X80,0XFF,0X00,0X00,0X09,0XFE,0X00,0X04,0XE0,0XC0,0X00,0X03,0X04,
+0XF6,0X00,0X02,0X0C,0X00,0X60,0XFC,0X00,0X01,0X01,0X07,0XFE,0X00,0X00,0XC0,0XF1,
+0X00,0X00,0X20,0XFE,0X00,0X01,0X07,0XFE,0XFF,0X00,0X00,0X30,0XF5,0X00,0X00,0X20,
+0XFE,0X00,0X00,0X18,0XFA,0X00,0X00,0X0C,0XF5,0X00,0X00,0X50,0XFE,0X00,0X00,0X80,
+0XED,0X00,0X00,0X08,0XFF,0X00,0X01,0X12,0X01,0XFF,0X00,0X03,0X01,0XFF,0XFE,0X07,
+0XF3,0X00,0X00,0X44,0XFF,0X00,0X01,0X0E,0X42,0XED,0X00,0X00,0X20,0XFE,0X00,0X00,
+0X3C,0XF6,0X00,0X00,0X80,0XFD,0X00,0X00,0X02,0XFE,0X00,0X00,0X10,0XF3,0X00,0X01,
+0X01,0X7F,0XFD,0XFF,0X00,0XFD,0XFE,0X00,0X02,0X10,0X00,0X03,0XFF,0XFF,0XF6,0X00,
+0XFC,0XFF,0X01,0XFE,0X00,0XE6,0X00,0X00,0X20,0XE9,0X00,0X00,0X44,0XE9,0X00,0X04,
+0X08,0X00,0X03,0XE3,0XF1,0XED,0X00,0X00,0X90,0XFE,0X00,0X00,0X08,0XE9,0X00,0X00,
+0X01,0XED,0X00,0X00,0X20,0XFC,0X00,0X00,0X0F,0XFA,0XFF,0X00,0XF0,0XF8,0X00,0X00,
+0X01,0XFE,0X00,0X01,0X02,0X08,0XEE,0X00,0X01,0X01,0X20,0XFF,0X00,0X03,0X11,0XF0,
+0X00,0X0F,0XFA,0XFF,0X00,0XF0,0XF3,0X00,0X00,0X01,0XEF,0X00,0XFF,0X00,0X00,0X10,
+0XFF,0X00,0X00,0X08,0XEC,0X00,0X00,0X88,0XFF,0X00,0XFF,0X06,0XED,0X00,0X00,0X48,
+0XFF,0X00,0X01,0X01,0XF8,0XED,0X00,0X00,0X30,0XE6,0X00,0X01,0X07,0XFF,0XED,0X00,
+0X00,0X07,0XFF,0X00,0X00,0X08,0XED,0X00,0X04,0X07,0X88,0XC0,0X00,0X10,0XF2,0X00,
+0X00,0X05,0XFD,0X00,0X02,0X08,0X50,0X20,0XF0,0X00,0X01,0X3A,0XE0,0XFE,0X00,0X01,
+0X10,0X22,0XFF,0X00,0X01,0X03,0XFF,0XF3,0X00,0X01,0XC0,0X10,0XFE,0X00,0X01,0X03,
+0X85,0XF0,0X00,0X02,0X01,0X00,0X08,0XFF,0X00,0X03,0X00,0X04,0X08,0X90,0XEF,0X00,
+0X01,0X05,0X80,0XFE,0X00,0X00,0X40,0XFF,0X00,0X00,0X13,0XF3,0X00,0X02,0X02,0X00,
+0X02,0XFC,0X00,0X03,0X10,0X00,0X10,0XFF,0XF4,0X00,0X00,0X04,0XFF,0X00,0X00,0X80,
+0XFF,0X00,0X02,0X04,0X30,0X80,0XF0,0X00,0X00,0X30,0XFD,0X00,0X01,0X10,0X01,0XEA,
+0X00,0X02,0X04,0X01,0X20,0XF1,0X00,0X01,0X08,0X30,0XFD,0X00,0X05,0X08,0X00,0XC0,
+0X00,0X1F,0XFF,0XDB,0X00,0X00,0X60,0XFA,0X00,0X00,0XE0,0XF1,0X00,0X00,0X80,0XFC,
+0X00,0X01,0X07,0XE0,0XFF,0X00,0X01,0X1F,0XFF,0XF5,0X00,0X00,0X03,0XFC,0X00,0X02,
+0X00,0X08,0X10,0XF1,0X00,0X02,0X04,0X08,0X30,0XFD,0X00,0X01,0X10,0X0C,0XF0,0X00,
+0X01,0X10,0X08,0XFD,0X00,0X02,0X03,0XC2,0X80,0XF2,0X00,0X03,0X08,0X00,0X08,0X01,
+0XFE,0X00,0X01,0X04,0X31,0XFF,0X00,0X01,0X1F,0XE1,0XF5,0X00,0X02,0X10,0X00,0X30,
+0XFC,0X00,0X01,0X08,0X80,0XFF,0X00,0X00,0X18,0XF4,0X00,0X00,0XEC,0XFB,0X00,0X00,
+0X04,0XFE,0X00,0X00,0X01,0XF4,0X00,0X02,0X06,0X00,0X02,0XFE,0X00,0X01,0X04,0X02,
+0XF1,0X00,0X00,0X20,0XFF,0X00,0X00,0X04,0XFE,0X00,0X01,0X12,0X01,0XFF,0X00,0X01,
+0X1F,0XF8,0XF4,0X00,0X02,0XA3,0X00,0X08,0XFE,0X00,0X02,0X02,0X00,0X80,0XF1,0X00,
+0X02,0X41,0XC0,0X10,0XFE,0X00,0X02,0X0C,0X00,0X60,0XFF,0X00,0X00,0X01,0XF3,0X00,
+0X01,0XF0,0XE0,0XFF,0X00,0XFB,0X00,0X00,0X02,0XF3,0X00,0X01,0X37,0X80,0XFA,0X00,
+0X01,0X1F,0XFC,0XF3,0X00,0X01,0X07,0X40,0XE9,0X00,0X00,0X40,0XEB,0X00,0X00,0X40,
+0XFB,0X00,0X00,0X40,0XF0,0X00,0X00,0XA0,0XFB,0X00,0X00,0X80,0XFE,0X00,0X00,0X78,
+0XF5,0X00,0X00,0X20,0XF7,0X00,0X01,0XE1,0X84,0XEF,0X00,0X06,0X01,0X00,0X80,0X30,
+0X01,0X20,0X02,0XF4,0X00,0X02,0XE0,0X00,0X40,0XFE,0X00,0X00,0XC0,0XFF,0X40,0X01,
+0X00,0X02,0XF4,0X00,0X00,0X10,0XFC,0X00,0X03,0X01,0X03,0XF0,0X10,0XFF,0X00,0X00,
+0X31,0XF5,0X00,0X03,0X08,0X00,0X01,0X20,0XFF,0X00,0X03,0X00,0XCC,0X0C,0X60,0XFF,
+0X00,0X00,0X48,0XF3,0X00,0X01,0X02,0XE0,0XFE,0X00,0X01,0X10,0X03,0XFF,0X00,0X00,
+0X04,0XF4,0X00,0X02,0X04,0X00,0X04,0XFD,0X00,0X00,0X20,0XFE,0X00,0X00,0X20,0XF4,
+0X00,0X02,0X03,0X00,0X08,0XFB,0X00,0X03,0X80,0X00,0X18,0X80,0XF4,0X00,0X01,0X80,
+0X30,0XFD,0X00,0X03,0X40,0X00,0X40,0X01,0XF2,0X00,0X01,0X7F,0XC0,0XF9,0X00,0X01,
+0X01,0X08,0XEA,0X00,0X01,0XC2,0X01,0XEF,0X00,0X06,0X0E,0X80,0X00,0X0E,0X00,0X3C,
+0X0E,0XD6,0X00,0X03,0X0E,0X80,0X00,0X0E,0XEC,0X00,0XE5,0X00,0X00,0X40,0XEB,0X00,
+0X00,0X40,0XE9,0X00,0X02,0X20,0X00,0X80,0XEB,0X00,0X01,0X10,0X01,0XEA,0X00,0X02,
+0X88,0X02,0X20,0XEC,0X00,0X03,0X01,0X47,0X1C,0X50,0XEB,0X00,0X02,0X40,0XE0,0X40,
+0XEB,0X00,0X02,0X80,0XC0,0X30,0XEC,0X00,0X00,0X01,0XE9,0X00,0XE6,0X00,0X00,0XC0,
+0XF1,0X00,0XFE,0XFF,0X02,0XFE,0X80,0X00,0XF9,0XFF,0X00,0X80,0XF8,0X00,0X01,0X02,
+0X80,0XFF,0X00,0X01,0X02,0X60,0XEE,0X00,0X00,0X05,0XFE,0X00,0X02,0X01,0X10,0X00,
+0XF9,0XFF,0X00,0X80,0XF8,0X00,0X01,0X08,0XC0,0XFF,0X00,0X00,0X06,0XEC,0X00,0X00,
+0X20,0XFF,0X00,0XFF,0X08,0XED,0X00,0X00,0X40,0XFF,0X00,0X00,0X04,0XEC,0X00,0X00,
+0X10,0XFF,0X00,0X00,0X18,0XEC,0X00,0X00,0X20,0XFF,0X00,0X00,0X20,0XEC,0X00,0X00,
+0X08,0XFF,0X00,0X00,0X10,0XFF,0X00,0XEE,0X00,0X00,0X10,0XFF,0X00,0X00,0X40,0XEC,
+0X00,0X00,0X0C,0XFF,0X00,0X00,0X20,0XEC,0X00,0X00,0X02,0XFF,0X00,0X00,0XC0,0XEC,
+0X00,0X02,0X04,0X00,0X01,0XEB,0X00,0X00,0X01,0XFF,0X00,0X00,0X80,0XFC,0X00,0X00,
+0X1F,0XFE,0XFF,0XF5,0X00,0X02,0X02,0X00,0X03,0XFB,0X00,0X00,0XE0,0XF1,0X00,0X01,
+0X80,0X04,0XFC,0X00,0X00,0X03,0XF1,0X00,0X02,0X01,0X00,0X02,0XFC,0X00,0X02,0X0C,
+0X00,0X38,0XF2,0X00,0X01,0XC0,0X0C,0XFC,0X00,0X02,0X10,0X00,0XC6,0XED,0X00,0XFF,
+0X00,0X03,0X20,0X03,0X01,0X80,0XF3,0X00,0X01,0X60,0X18,0XFC,0X00,0X03,0X40,0X0C,
+0X00,0X78,0XF3,0X00,0X01,0X10,0X20,0XFC,0X00,0X03,0X80,0X30,0X00,0X04,0XF3,0X00,
+0X01,0X20,0X10,0XFD,0X00,0X04,0X01,0X00,0XC0,0X18,0X02,0XF3,0X00,0X01,0X08,0X60,
+0XFD,0X00,0X04,0X02,0X01,0X00,0X66,0X01,0XF3,0X00,0X01,0X10,0X80,0XFA,0X00,0X01,
+0X81,0X80,0XF3,0X00,0X01,0X0C,0X40,0XFD,0X00,0X00,0X04,0XFF,0X00,0X02,0XC0,0X00,
+0X80,0XF4,0X00,0X01,0X01,0X80,0XFC,0X00,0X04,0X01,0X00,0X38,0X7F,0X80,0XF4,0X00,
+0X00,0X06,0XFC,0X00,0X03,0X08,0X00,0XE0,0X06,0XEA,0X00,0X02,0X18,0X01,0X80,0XF3,
+0X00,0X00,0X02,0XFD,0X00,0X03,0X00,0X01,0XFF,0X86,0XF0,0X00,0X00,0X80,0XFD,0X00,
+0X03,0X11,0X00,0X81,0X80,0XF3,0X00,0X01,0X47,0X81,0XFB,0X00,0X02,0X80,0XC1,0X40,
+0XF3,0X00,0X02,0X08,0X40,0XC0,0XFC,0X00,0X03,0X40,0X38,0X70,0X80,0XF4,0X00,0X01,
+0X03,0X80,0XFB,0X00,0X02,0X20,0X07,0X37,0XF3,0X00,0X01,0X28,0X80,0XFB,0X00,0X02,
+0X10,0X01,0XF8,0XF3,0X00,0X00,0X1B,0XFA,0X00,0X02,0X0A,0X00,0X70,0XF3,0X00,0X02,
+0X60,0XC0,0X80,0XFC,0X00,0X02,0X05,0XC0,0X0C,0XF3,0X00,0X02,0X1F,0X00,0X40,0XFB,
+0X00,0X01,0X30,0X03,0XF2,0X00,0X01,0X01,0X80,0XFB,0X00,0X02,0X0C,0X00,0X80,0XEE,
+0X00,0XFE,0X00,0X00,0X04,0XFF,0X00,0X00,0X01,0XF4,0X00,0X00,0X03,0XFA,0X00,0X02,
+0X38,0X00,0X80,0XF3,0X00,0X00,0X04,0XFA,0X00,0X01,0XC0,0X03,0XF2,0X00,0X00,0X03,
+0XFB,0X00,0X02,0X01,0X00,0X1C,0XF2,0X00,0X01,0X08,0X80,0XFA,0X00,0X02,0XE0,0X00,
+0X02,0XF4,0X00,0X00,0X05,0XF9,0X00,0X00,0X80,0XF2,0X00,0X01,0X18,0XC0,0XFC,0X00,
+0X02,0X01,0X00,0X70,0XEA,0X00,0X03,0XE0,0X0E,0X00,0X04,0XF4,0X00,0X01,0X30,0X60,
+0XFB,0X00,0X02,0X1C,0X01,0X80,0XF3,0X00,0X01,0X40,0X10,0XFB,0X00,0X00,0X04,0XFF,
+0X00,0X00,0X08,0XF4,0X00,0XFF,0X20,0XFE,0X00,0XFE,0X00,0X00,0X38,0XFF,0X00,0X00,
+0X10,0XF4,0X00,0X01,0X80,0X18,0XFC,0X00,0X03,0X01,0XC0,0X00,0X80,0XF3,0X00,0X01,
+0X40,0X04,0XFA,0X00,0X02,0X07,0X00,0X20,0XF5,0X00,0X02,0X01,0X00,0X08,0XFA,0X00,
+0X02,0X18,0X00,0X40,0XF4,0X00,0X01,0X80,0X06,0XFB,0X00,0X03,0X01,0XE0,0X00,0X80,
+0XF5,0X00,0X02,0X03,0X00,0X01,0XFB,0X00,0X02,0X0E,0X00,0X03,0XF4,0X00,0X02,0X04,
+0X00,0X02,0XFB,0X00,0X02,0X70,0X00,0X04,0XF4,0X00,0X00,0X02,0XFF,0X00,0X00,0X80,
+0XFD,0X00,0X03,0X01,0X80,0X00,0X18,0XF4,0X00,0X02,0X08,0X00,0X01,0XF9,0X00,0X00,
+0XE0,0XF4,0X00,0X00,0X04,0XFF,0X00,0X00,0XC0,0XFB,0X00,0X00,0X0F,0XF3,0X00,0X00,
+0X10,0XFF,0X00,0X00,0X20,0XFF,0X00,0X01,0X00,0X1F,0XFF,0XFF,0X00,0XF0,0XF3,0X00,
+0X00,0X08,0XFF,0X00,0X00,0X40,0XEC,0X00,0X00,0X30,0XFF,0X00,0X00,0X30,0XEC,0X00,
+0X00,0X40,0XFF,0X00,0X00,0X08,0XEC,0X00,0X00,0X20,0XFF,0X00,0X00,0X10,0XED,0X00,
+0X01,0X08,0X80,0XFF,0X00,0X01,0X0C,0X08,0XED,0X00,0X00,0X40,0XFE,0X00,0X00,0X10,
+0XEE,0X00,0X01,0X07,0X80,0XFF,0X00,0X01,0X06,0X20,0XED,0X00,0XFE,0XFF,0X01,0XFD,
+0XC0,0XCE,0X00,
+};
@@ -0,0 +1,473 @@
+/**
+ *  @filename   :   imageloader.cpp
+ *  @brief      :   Implements the PBM, PGM and BMP loaders
+ */
+
+#include <string.h>
+#include "imageloader.h"
+#include "framewriter.h"
+
+FileStream::FileStream(FILE *file) : m_file(file)
+{
+}
+
+int FileStream::Read(void *buffer, int length)
+{
+    size_t n = fread(buffer, 1, length, m_file);
+
+    if (n == 0 && ferror(m_file))
+    {
+        return -1;
+    }
+    return n;
+}
+
+#if defined(__MBED__)
+FileHandleStream::FileHandleStream(mbed::FileHandle *file) : m_file(file)
+{
+}
+
+int FileHandleStream::Read(void *buffer, int length)
+{
+    ssize_t n = m_file->read(buffer, length);
+
+    return n < 0 ? -1 : n;
+}
+
+BlockDeviceStream::BlockDeviceStream(mbed::BlockDevice *device, mbed::bd_addr_t offset) : m_device(device)
+{
+    int read_size = device->get_read_size();
+
+    /* whole read units, at least IMAGE_CHUNK_SIZE bytes */
+    m_block_size = (IMAGE_CHUNK_SIZE + read_size - 1) / read_size * read_size;
+    m_block = new unsigned char[m_block_size];
+    m_address = offset / read_size * read_size;
+    m_position = offset - m_address;
+    m_length = 0;
+}
+
+BlockDeviceStream::~BlockDeviceStream()
+{
+    delete[] m_block;
+}
+
+int BlockDeviceStream::Read(void *buffer, int length)
+{
+    unsigned char *out = (unsigned char *)buffer;
+    int count = 0;
+
+    while (count < length)
+    {
+        if (m_position >= m_length)
+        {
+            if (m_length > 0)
+            {
+                m_address += m_length;
+                m_position -= m_length;
+            }
+            mbed::bd_size_t left = m_device->size() - m_address;
+            m_length = left < (mbed::bd_size_t)m_block_size ? (int)left : m_block_size;
+            if (m_length <= 0 || m_device->read(m_block, m_address, m_length) != 0)
+            {
+                m_length = 0;
+                return count > 0 ? count : -1;
+            }
+            if (m_position >= m_length)
+            {
+                continue;
+            }
+        }
+        int n = m_length - m_position;
+        if (n > length - count)
+        {
+            n = length - count;
+        }
+        memcpy(out + count, m_block + m_position, n);
+        m_position += n;
+        count += n;
+    }
+    return count;
+}
+#endif
+
+/* reads a stream in chunks, for parsing the headers byte by byte */
+class ImageReader
+{
+public:
+    ImageReader(ImageStream &stream) : m_stream(stream),
+                                       m_position(0),
+                                       m_length(0),
+                                       m_offset(0)
+    {
+    }
+
+    /* next byte, -1 at the end */
+    int GetByte(void)
+    {
+        if (m_position >= m_length)
+        {
+            int n = m_stream.Read(m_chunk, sizeof(m_chunk));
+            if (n <= 0)
+            {
+                return -1;
+            }
+            m_position = 0;
+            m_length = n;
+        }
+        m_offset++;
+        return m_chunk[m_position++];
+    }
+
+    bool Read(void *buffer, int length)
+    {
+        unsigned char *out = (unsigned char *)buffer;
+
+        while (length > 0)
+        {
+            if (m_position >= m_length)
+            {
+                int c = GetByte();
+                if (c < 0)
+                {
+                    return false;
+                }
+                *out++ = c;
+                length--;
+                continue;
+            }
+            int n = m_length - m_position < length ? m_length - m_position : length;
+            memcpy(out, &m_chunk[m_position], n);
+            m_position += n;
+            m_offset += n;
+            out += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    bool Skip(long length)
+    {
+        while (length-- > 0)
+        {
+            if (GetByte() < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    long Offset(void)
+    {
+        return m_offset;
+    }
+
+    /* netpbm header number, after white space and comments */
+    bool ReadNumber(int *value)
+    {
+        int c = GetByte();
+
+        while (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#')
+        {
+            if (c == '#')
+            {
+                while (c >= 0 && c != '\n')
+                {
+                    c = GetByte();
+                }
+            }
+            c = GetByte();
+        }
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        *value = 0;
+        while (c >= '0' && c <= '9')
+        {
+            if (*value > 100000)
+            {
+                return false;
+            }
+            *value = *value * 10 + c - '0';
+            c = GetByte();
+        }
+        /* a single white space character ends the header */
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    unsigned long ReadLittleEndian(int bytes)
+    {
+        unsigned long value = 0;
+
+        for (int i = 0; i < bytes; i++)
+        {
+            int c = GetByte();
+            value |= (unsigned long)(c < 0 ? 0 : c) << (8 * i);
+        }
+        return value;
+    }
+
+private:
+    ImageStream &m_stream;
+    unsigned char m_chunk[IMAGE_CHUNK_SIZE];
+    int m_position;
+    int m_length;
+    long m_offset;
+};
+
+/**
+ *  @brief: private function to load a PBM after its magic number
+ */
+static int ReadPbm(Epd &epd, ImageReader &reader, int x, int y)
+{
+    unsigned char row[(IMAGE_MAX_WIDTH + 7) / 8];
+    int image_width, image_height;
+
+    if (!reader.ReadNumber(&image_width) || !reader.ReadNumber(&image_height))
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    if (image_width <= 0 || image_height <= 0 || image_width > IMAGE_MAX_WIDTH)
+    {
+        return IMAGE_ERROR_SIZE;
+    }
+
+    int row_bytes = (image_width + 7) / 8;
+    FrameMemoryWriter writer(epd, x, y, image_width, image_height, false);
+    for (int j = 0; j < image_height; j++)
+    {
+        if (!reader.Read(row, row_bytes))
+        {
+            return IMAGE_ERROR_READ;
+        }
+        /* 1 is black in PBM */
+        for (int i = 0; i < row_bytes; i++)
+        {
+            row[i] = ~row[i];
+        }
+        writer.WriteRow(row);
+    }
+    return IMAGE_OK;
+}
+
+static void DitherToWriter(void *context, int, const unsigned char *row, int)
+{
+    ((FrameMemoryWriter *)context)->WriteRow(row);
+}
+
+/**
+ *  @brief: private function to load a PGM after its magic number
+ */
+static int ReadPgm(Epd &epd, ImageReader &reader, int x, int y, int method)
+{
+    unsigned char row[IMAGE_MAX_WIDTH];
+    int image_width, image_height, max_value;
+
+    if (!reader.ReadNumber(&image_width) || !reader.ReadNumber(&image_height) ||
+        !reader.ReadNumber(&max_value))
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    if (max_value <= 0 || max_value > 255)
+    {
+        /* 16 bit samples are not supported */
+        return IMAGE_ERROR_FORMAT;
+    }
+    if (image_width <= 0 || image_height <= 0 || image_width > IMAGE_MAX_WIDTH)
+    {
+        return IMAGE_ERROR_SIZE;
+    }
+
+    /* scale down to fit the display, keeping the aspect */
+    int width = image_width;
+    int height = image_height;
+    int max_width = (int)epd.width < DITHER_MAX_WIDTH ? (int)epd.width : DITHER_MAX_WIDTH;
+    if (width > max_width)
+    {
+        height = (long)height * max_width / width;
+        width = max_width;
+    }
+    if (height > (int)epd.height)
+    {
+        width = (long)width * epd.height / height;
+        height = epd.height;
+    }
+    if (width <= 0 || height <= 0)
+    {
+        return IMAGE_ERROR_SIZE;
+    }
+
+    FrameMemoryWriter writer(epd, x, y, width, height, false);
+    GrayDither dither(image_width, image_height, width, height, method, DitherToWriter, &writer);
+    if (!dither.IsValid())
+    {
+        return IMAGE_ERROR_SIZE;
+    }
+    for (int j = 0; j < image_height; j++)
+    {
+        if (!reader.Read(row, image_width))
+        {
+            return IMAGE_ERROR_READ;
+        }
+        if (max_value != 255)
+        {
+            for (int i = 0; i < image_width; i++)
+            {
+                row[i] = row[i] >= max_value ? 255 : row[i] * 255 / max_value;
+            }
+        }
+        dither.PushRow(row);
+    }
+    return IMAGE_OK;
+}
+
+/**
+ *  @brief: private function to load a BMP after its magic number
+ */
+static int ReadBmp(Epd &epd, ImageReader &reader, int x, int y)
+{
+    unsigned char row[(IMAGE_MAX_WIDTH + 31) / 32 * 4];
+    unsigned char palette[8];
+
+    /* file size, reserved */
+    reader.Skip(8);
+    unsigned long data_offset = reader.ReadLittleEndian(4);
+    unsigned long header_size = reader.ReadLittleEndian(4);
+    if (header_size < 40)
+    {
+        /* OS/2 bitmaps are not supported */
+        return IMAGE_ERROR_FORMAT;
+    }
+    long image_width = (long)reader.ReadLittleEndian(4);
+    long image_height = (long)reader.ReadLittleEndian(4);
+    /* sign extend the 32 bit values */
+    image_width = (image_width ^ 0x80000000L) - 0x80000000L;
+    image_height = (image_height ^ 0x80000000L) - 0x80000000L;
+    int planes = reader.ReadLittleEndian(2);
+    int bits = reader.ReadLittleEndian(2);
+    unsigned long compression = reader.ReadLittleEndian(4);
+    if (planes != 1 || bits != 1 || compression != 0)
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    /* negative height stores the rows top down */
+    bool bottom_up = image_height > 0;
+    if (image_height < 0)
+    {
+        image_height = -image_height;
+    }
+    if (image_width <= 0 || image_height == 0 || image_width > IMAGE_MAX_WIDTH)
+    {
+        return IMAGE_ERROR_SIZE;
+    }
+
+    /* two BGRx palette entries after the header */
+    if (!reader.Skip(14 + header_size - reader.Offset()) || !reader.Read(palette, sizeof(palette)))
+    {
+        return IMAGE_ERROR_READ;
+    }
+    /* bits are palette indices, 1 is white in the frame buffer */
+    int luma0 = palette[0] + 2 * palette[1] + palette[2];
+    int luma1 = palette[4] + 2 * palette[5] + palette[6];
+    unsigned char invert = luma0 > luma1 ? 0xFF : 0x00;
+    if ((long)data_offset < reader.Offset() || !reader.Skip(data_offset - reader.Offset()))
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+
+    /* rows padded to 4 bytes */
+    int stride = (image_width + 31) / 32 * 4;
+    FrameMemoryWriter writer(epd, x, y, image_width, image_height, bottom_up);
+    for (int j = 0; j < image_height; j++)
+    {
+        if (!reader.Read(row, stride))
+        {
+            return IMAGE_ERROR_READ;
+        }
+        if (invert)
+        {
+            for (int i = 0; i < stride; i++)
+            {
+                row[i] ^= invert;
+            }
+        }
+        writer.WriteRow(row);
+    }
+    return IMAGE_OK;
+}
+
+/**
+ *  @brief: load a PBM, PGM or BMP image, told apart by its magic number,
+ *          into the display RAM at x, y. PGM images are dithered with
+ *          Floyd-Steinberg, use LoadPgm to choose.
+ */
+int LoadImage(Epd &epd, ImageStream &stream, int x, int y)
+{
+    ImageReader reader(stream);
+    int c0 = reader.GetByte();
+    int c1 = reader.GetByte();
+
+    if (c0 < 0 || c1 < 0)
+    {
+        return IMAGE_ERROR_READ;
+    }
+    if (c0 == 'P' && c1 == '4')
+    {
+        return ReadPbm(epd, reader, x, y);
+    }
+    if (c0 == 'P' && c1 == '5')
+    {
+        return ReadPgm(epd, reader, x, y, DITHER_FLOYD_STEINBERG);
+    }
+    if (c0 == 'B' && c1 == 'M')
+    {
+        return ReadBmp(epd, reader, x, y);
+    }
+    return IMAGE_ERROR_FORMAT;
+}
+
+/**
+ *  @brief: load a binary PBM (P4) image into the display RAM at x, y
+ */
+int LoadPbm(Epd &epd, ImageStream &stream, int x, int y)
+{
+    ImageReader reader(stream);
+
+    if (reader.GetByte() != 'P' || reader.GetByte() != '4')
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    return ReadPbm(epd, reader, x, y);
+}
+
+/**
+ *  @brief: load a binary PGM (P5) image into the display RAM at x, y,
+ *          scaled down to fit and dithered with method DITHER_BAYER
+ *          or DITHER_FLOYD_STEINBERG
+ */
+int LoadPgm(Epd &epd, ImageStream &stream, int x, int y, int method)
+{
+    ImageReader reader(stream);
+
+    if (reader.GetByte() != 'P' || reader.GetByte() != '5')
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    return ReadPgm(epd, reader, x, y, method);
+}
+
+/**
+ *  @brief: load an uncompressed 1-bit BMP image into the display RAM
+ *          at x, y
+ */
+int LoadBmp(Epd &epd, ImageStream &stream, int x, int y)
+{
+    ImageReader reader(stream);
+
+    if (reader.GetByte() != 'B' || reader.GetByte() != 'M')
+    {
+        return IMAGE_ERROR_FORMAT;
+    }
+    return ReadBmp(epd, reader, x, y);
+}
@@ -0,0 +1,97 @@
+/**
+ *  @filename   :   imageloader.h
+ *  @brief      :   Loads PBM (P4), PGM (P5) and 1-bit BMP images from
+ *                  storage straight into the display RAM. The image is
+ *                  read in small chunks and written row by row through
+ *                  FrameMemoryWriter, so no frame buffer is needed.
+ *                  Grayscale images are scaled down to fit the display
+ *                  and dithered.
+ *
+ *                  FileStream reads a stdio FILE, on the target
+ *                  FileHandleStream and BlockDeviceStream read from an
+ *                  mbed FileHandle or raw from a BlockDevice.
+ *
+ *                  FILE *file = fopen("/sd/logo.pbm", "rb");
+ *                  FileStream stream(file);
+ *                  if (LoadImage(epd, stream, 0, 0) == IMAGE_OK)
+ *                      epd.DisplayFrame();
+ */
+
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <stdio.h>
+#include "epd1in54v2.h"
+#include "dither.h"
+#if defined(__MBED__)
+#include "BlockDevice.h"
+#endif
+
+#define IMAGE_OK 0
+#define IMAGE_ERROR_READ -1
+#define IMAGE_ERROR_FORMAT -2
+#define IMAGE_ERROR_SIZE -3
+
+// Widest source image in pixels
+#ifndef IMAGE_MAX_WIDTH
+#define IMAGE_MAX_WIDTH 400
+#endif
+
+/* bytes read from a stream at a time */
+#define IMAGE_CHUNK_SIZE 64
+
+class ImageStream
+{
+public:
+    virtual ~ImageStream() {}
+    /* returns the number of bytes read, less at the end, or -1 */
+    virtual int Read(void *buffer, int length) = 0;
+};
+
+class FileStream : public ImageStream
+{
+public:
+    FileStream(FILE *file);
+    virtual int Read(void *buffer, int length);
+
+private:
+    FILE *m_file;
+};
+
+#if defined(__MBED__)
+class FileHandleStream : public ImageStream
+{
+public:
+    FileHandleStream(mbed::FileHandle *file);
+    virtual int Read(void *buffer, int length);
+
+private:
+    mbed::FileHandle *m_file;
+};
+
+/* an image stored raw on a block device, starting at offset */
+class BlockDeviceStream : public ImageStream
+{
+public:
+    BlockDeviceStream(mbed::BlockDevice *device, mbed::bd_addr_t offset);
+    virtual ~BlockDeviceStream();
+    virtual int Read(void *buffer, int length);
+
+private:
+    mbed::BlockDevice *m_device;
+    mbed::bd_addr_t m_address; /* of the buffered block */
+    unsigned char *m_block;
+    int m_block_size;
+    int m_position; /* in the buffered block */
+    int m_length;   /* valid bytes in the buffered block */
+};
+#endif
+
+int LoadImage(Epd &epd, ImageStream &stream, int x, int y);
+int LoadPbm(Epd &epd, ImageStream &stream, int x, int y);
+int LoadPgm(Epd &epd, ImageStream &stream, int x, int y, int method);
+int LoadBmp(Epd &epd, ImageStream &stream, int x, int y);
+
+#endif /* IMAGELOADER_H */
+
+/* END OF FILE */
@@ -0,0 +1,196 @@
+/**
+ *  @filename   :   imagepack.cpp
+ *  @brief      :   Implements the compressed 1-bit image format
+ */
+
+#include <string.h>
+#include "imagepack.h"
+
+/**
+ *  @brief: PackBits code length bytes of src into dst.
+ *          returns the number of bytes written, 0 if dst is too small.
+ */
+static size_t PackBits(const unsigned char *src, size_t length, unsigned char *dst, size_t size)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < length)
+    {
+        size_t run = 1;
+        while (in + run < length && run < 128 && src[in + run] == src[in])
+        {
+            run++;
+        }
+        if (run >= 2)
+        {
+            if (out + 2 > size)
+            {
+                return 0;
+            }
+            dst[out++] = (unsigned char)(257 - run);
+            dst[out++] = src[in];
+            in += run;
+            continue;
+        }
+
+        /* literal bytes up to the next run of two */
+        size_t literal = 1;
+        while (in + literal < length && literal < 128 &&
+               !(in + literal + 1 < length && src[in + literal] == src[in + literal + 1]))
+        {
+            literal++;
+        }
+        if (out + 1 + literal > size)
+        {
+            return 0;
+        }
+        dst[out++] = (unsigned char)(literal - 1);
+        memcpy(&dst[out], &src[in], literal);
+        out += literal;
+        in += literal;
+    }
+    return out;
+}
+
+/**
+ *  @brief: compress a width x height image in frame buffer format.
+ *          runs are coded across row ends, one image is one PackBits
+ *          stream. returns the packed size, 0 if packed is too small.
+ */
+size_t PackImage(const unsigned char *image, int width, int height, int flags,
+                 unsigned char *packed, size_t size)
+{
+    int row_bytes = (width + 7) / 8;
+    size_t out = IMAGE_PACK_HEADER_SIZE;
+
+    if (size < IMAGE_PACK_HEADER_SIZE || width <= 0 || height <= 0 ||
+        ((flags & IMAGE_PACK_ROW_DELTA) && row_bytes > IMAGE_PACK_MAX_ROW))
+    {
+        return 0;
+    }
+    packed[0] = (unsigned char)flags;
+    packed[1] = width & 0xFF;
+    packed[2] = (width >> 8) & 0xFF;
+    packed[3] = height & 0xFF;
+    packed[4] = (height >> 8) & 0xFF;
+
+    if (!(flags & IMAGE_PACK_ROW_DELTA))
+    {
+        size_t n = PackBits(image, (size_t)row_bytes * height, &packed[out], size - out);
+        return n == 0 ? 0 : out + n;
+    }
+
+    /* delta rows are built and coded a block of rows at a time */
+    unsigned char block[8 * IMAGE_PACK_MAX_ROW];
+    int block_rows = sizeof(block) / row_bytes;
+    for (int j = 0; j < height; j += block_rows)
+    {
+        int rows = height - j < block_rows ? height - j : block_rows;
+        for (int k = 0; k < rows; k++)
+        {
+            const unsigned char *row = &image[(j + k) * row_bytes];
+            for (int i = 0; i < row_bytes; i++)
+            {
+                block[k * row_bytes + i] = j + k == 0 ? row[i] : row[i] ^ row[i - row_bytes];
+            }
+        }
+        size_t n = PackBits(block, (size_t)rows * row_bytes, &packed[out], size - out);
+        if (n == 0)
+        {
+            return 0;
+        }
+        out += n;
+    }
+    return out;
+}
+
+ImageUnpacker::ImageUnpacker(const unsigned char *packed) : m_src(packed + IMAGE_PACK_HEADER_SIZE),
+                                                            m_flags(packed[0]),
+                                                            m_width(packed[1] | (packed[2] << 8)),
+                                                            m_height(packed[3] | (packed[4] << 8)),
+                                                            m_run(0),
+                                                            m_repeat(false)
+{
+    memset(m_row, 0, sizeof(m_row));
+}
+
+int ImageUnpacker::GetWidth(void)
+{
+    return m_width;
+}
+
+int ImageUnpacker::GetHeight(void)
+{
+    return m_height;
+}
+
+int ImageUnpacker::GetRowBytes(void)
+{
+    return (m_width + 7) / 8;
+}
+
+/**
+ *  @brief: false if the rows are too wide to unpack
+ */
+bool ImageUnpacker::IsValid(void)
+{
+    return GetRowBytes() <= IMAGE_PACK_MAX_ROW;
+}
+
+/**
+ *  @brief: unpack the next row, valid until the next call
+ */
+const unsigned char *ImageUnpacker::ReadRow(void)
+{
+    int row_bytes = GetRowBytes();
+
+    if (m_flags & IMAGE_PACK_ROW_DELTA)
+    {
+        unsigned char delta[IMAGE_PACK_MAX_ROW];
+        Unpack(delta, row_bytes);
+        for (int i = 0; i < row_bytes; i++)
+        {
+            m_row[i] ^= delta[i];
+        }
+    }
+    else
+    {
+        Unpack(m_row, row_bytes);
+    }
+    return m_row;
+}
+
+void ImageUnpacker::Unpack(unsigned char *out, int length)
+{
+    while (length > 0)
+    {
+        if (m_run == 0)
+        {
+            int n = *m_src++;
+            if (n == 128)
+            {
+                continue;
+            }
+            m_repeat = n > 128;
+            m_run = m_repeat ? 257 - n : n + 1;
+        }
+        int count = m_run < length ? m_run : length;
+        if (m_repeat)
+        {
+            memset(out, *m_src, count);
+            if (count == m_run)
+            {
+                m_src++;
+            }
+        }
+        else
+        {
+            memcpy(out, m_src, count);
+            m_src += count;
+        }
+        out += count;
+        length -= count;
+        m_run -= count;
+    }
+}
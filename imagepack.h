@@ -0,0 +1,58 @@
+/**
+ *  @filename   :   imagepack.h
+ *  @brief      :   Compressed 1-bit images for Epd::SetFrameMemoryPacked.
+ *
+ *                  A packed image starts with a IMAGE_PACK_HEADER_SIZE
+ *                  byte header:
+ *                      flags, width (lo, hi), height (lo, hi)
+ *                  followed by the rows in frame buffer format (msb first,
+ *                  rows padded to whole bytes), PackBits coded:
+ *                      n = 0..127     n + 1 literal bytes follow
+ *                      n = 129..255   the next byte repeats 257 - n times
+ *                      n = 128        no operation
+ *                  With IMAGE_PACK_ROW_DELTA every row is stored XORed with
+ *                  the row above, which turns vertical runs into zeros.
+ *
+ *                  PackImage runs on the target as well as on a host to
+ *                  convert artwork, ImageUnpacker decodes one row at a time.
+ */
+
+#ifndef IMAGEPACK_H
+#define IMAGEPACK_H
+
+#include <stddef.h>
+
+#define IMAGE_PACK_HEADER_SIZE 5
+#define IMAGE_PACK_ROW_DELTA 0x01
+/* widest row ImageUnpacker handles, in bytes */
+#define IMAGE_PACK_MAX_ROW 32
+
+size_t PackImage(const unsigned char *image, int width, int height, int flags,
+                 unsigned char *packed, size_t size);
+
+class ImageUnpacker
+{
+public:
+    ImageUnpacker(const unsigned char *packed);
+
+    int GetWidth(void);
+    int GetHeight(void);
+    int GetRowBytes(void);
+    bool IsValid(void);
+    const unsigned char *ReadRow(void);
+
+private:
+    void Unpack(unsigned char *out, int length);
+
+    const unsigned char *m_src;
+    int m_flags;
+    int m_width;
+    int m_height;
+    int m_run;
+    bool m_repeat;
+    unsigned char m_row[IMAGE_PACK_MAX_ROW];
+};
+
+#endif /* IMAGEPACK_H */
+
+/* END OF FILE */
@@ -0,0 +1,190 @@
+/**
+ *  @filename   :   powermanager.cpp
+ *  @brief      :   Implements the power manager
+ */
+
+#include "powermanager.h"
+
+/**
+ *  @brief: high_direction picks Epd::HDirInit over Epd::LDirInit
+ *          for the first init
+ */
+PowerManager::PowerManager(Epd &epd, bool high_direction) : m_epd(epd),
+                                                            m_high_direction(high_direction),
+                                                            m_state(EPD_STATE_OFF),
+                                                            m_sleep_mode(SLEEP_MODE_1),
+                                                            m_timeout(POWER_IDLE_TIMEOUT),
+                                                            m_idle_since(0),
+                                                            m_ram_valid(false)
+{
+}
+
+/**
+ *  @brief: ms of idle before Poll puts the panel to sleep, 0 never
+ */
+void PowerManager::SetIdleTimeout(unsigned long timeout_ms)
+{
+    m_timeout = timeout_ms;
+}
+
+/**
+ *  @brief: SLEEP_MODE_1 or SLEEP_MODE_2, see Epd::Sleep
+ */
+void PowerManager::SetSleepMode(int mode)
+{
+    m_sleep_mode = mode;
+}
+
+int PowerManager::GetState(void)
+{
+    return m_state;
+}
+
+/**
+ *  @brief: make the panel ready for commands, waking or initialising
+ *          it as needed. pair with Release. returns 0, or the error
+ *          of the init or wake that failed.
+ */
+int PowerManager::Acquire(void)
+{
+    if (m_state == EPD_STATE_OFF)
+    {
+        int result = m_high_direction ? m_epd.HDirInit() : m_epd.LDirInit();
+        if (result != 0)
+        {
+            return result;
+        }
+        m_ram_valid = false;
+    }
+    else if (m_state == EPD_STATE_SLEEPING)
+    {
+        int result = m_epd.Wake();
+        if (result != 0)
+        {
+            /* a full init next time */
+            m_state = EPD_STATE_OFF;
+            return result;
+        }
+        if (m_sleep_mode == SLEEP_MODE_2)
+        {
+            m_ram_valid = false;
+        }
+    }
+    m_state = EPD_STATE_BUSY;
+    return 0;
+}
+
+/**
+ *  @brief: the panel is idle from now on
+ */
+void PowerManager::Release(void)
+{
+    m_state = EPD_STATE_IDLE;
+    m_idle_since = m_epd.GetMs();
+}
+
+/**
+ *  @brief: put the panel to sleep once the idle timeout is over.
+ *          returns the state.
+ */
+int PowerManager::Poll(void)
+{
+    if (m_state == EPD_STATE_IDLE && m_timeout > 0 && m_epd.GetMs() - m_idle_since >= m_timeout)
+    {
+        Sleep();
+    }
+    return m_state;
+}
+
+/**
+ *  @brief: deep sleep now, if awake
+ */
+void PowerManager::Sleep(void)
+{
+    if (m_state != EPD_STATE_IDLE)
+    {
+        return;
+    }
+    m_epd.Sleep(m_sleep_mode);
+    m_state = EPD_STATE_SLEEPING;
+}
+
+int PowerManager::Display(const unsigned char *frame_buffer)
+{
+    int result = Acquire();
+
+    if (result != 0)
+    {
+        return result;
+    }
+    result = m_epd.Display(frame_buffer);
+    /* only the 0x24 plane is written, partial refreshes need both */
+    m_ram_valid = false;
+    Release();
+    return result;
+}
+
+int PowerManager::DisplayPartBaseImage(const unsigned char *frame_buffer)
+{
+    int result = Acquire();
+
+    if (result != 0)
+    {
+        return result;
+    }
+    result = m_epd.DisplayPartBaseImage(frame_buffer);
+    m_ram_valid = result == 0;
+    Release();
+    return result;
+}
+
+/**
+ *  @brief: partial refresh, or a base image refresh if the display
+ *          RAM doesn't hold the last frame
+ */
+int PowerManager::DisplayPart(const unsigned char *frame_buffer)
+{
+    int result = Acquire();
+
+    if (result != 0)
+    {
+        return result;
+    }
+    if (m_ram_valid)
+    {
+        result = m_epd.DisplayPart(frame_buffer);
+    }
+    else
+    {
+        result = m_epd.DisplayPartBaseImage(frame_buffer);
+    }
+    /* after an error, start over with a base image */
+    m_ram_valid = result == 0;
+    Release();
+    return result;
+}
+
+/**
+ *  @brief: like DisplayPart, only uploading x, y, w, h
+ */
+int PowerManager::DisplayPartArea(const unsigned char *frame_buffer, int x, int y, int w, int h)
+{
+    int result = Acquire();
+
+    if (result != 0)
+    {
+        return result;
+    }
+    if (m_ram_valid)
+    {
+        result = m_epd.DisplayPartArea(frame_buffer, x, y, w, h);
+    }
+    else
+    {
+        result = m_epd.DisplayPartBaseImage(frame_buffer);
+    }
+    /* after an error, start over with a base image */
+    m_ram_valid = result == 0;
+    Release();
+    return result;
+}
@@ -0,0 +1,57 @@
+/**
+ *  @filename   :   powermanager.h
+ *  @brief      :   Keeps track of the controller state and puts the
+ *                  panel into deep sleep after it was idle for a while.
+ *                  The display functions here wake it, or init it the
+ *                  first time, before they pass the call on to Epd, so
+ *                  the application doesn't have to know whether the
+ *                  panel is asleep. Call Poll from the main loop.
+ */
+
+#ifndef POWERMANAGER_H
+#define POWERMANAGER_H
+
+#include "epd1in54v2.h"
+
+// Controller states
+#define EPD_STATE_OFF 0      /* not initialised */
+#define EPD_STATE_SLEEPING 1 /* deep sleep */
+#define EPD_STATE_IDLE 2     /* awake, waiting for commands */
+#define EPD_STATE_BUSY 3     /* in a display call */
+
+// Default ms of idle before deep sleep
+#define POWER_IDLE_TIMEOUT 5000
+
+class PowerManager
+{
+public:
+    PowerManager(Epd &epd, bool high_direction);
+
+    void SetIdleTimeout(unsigned long timeout_ms);
+    void SetSleepMode(int mode);
+    int GetState(void);
+
+    int Acquire(void);
+    void Release(void);
+    int Poll(void);
+    void Sleep(void);
+
+    int Display(const unsigned char *frame_buffer);
+    int DisplayPartBaseImage(const unsigned char *frame_buffer);
+    int DisplayPart(const unsigned char *frame_buffer);
+    int DisplayPartArea(const unsigned char *frame_buffer, int x, int y, int w, int h);
+
+private:
+    Epd &m_epd;
+    bool m_high_direction;
+    int m_state;
+    int m_sleep_mode;
+    unsigned long m_timeout;
+    unsigned long m_idle_since;
+    /* the display RAM holds the last frame, for partial refreshes */
+    bool m_ram_valid;
+};
+
+#endif /* POWERMANAGER_H */
+
+/* END OF FILE */
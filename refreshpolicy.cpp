@@ -0,0 +1,223 @@
+/**
+ *  @filename   :   refreshpolicy.cpp
+ *  @brief      :   Implements the refresh policy
+ */
+
+#include <string.h>
+#include "refreshpolicy.h"
+
+#define FRAME_SIZE (EPD_WIDTH * EPD_HEIGHT / 8)
+
+/**
+ *  @brief: shadow_buffer may be NULL. the first update is always full.
+ */
+RefreshPolicy::RefreshPolicy(Epd &epd, unsigned char *shadow_buffer) : m_epd(epd),
+                                                                       m_shadow(shadow_buffer),
+                                                                       m_shadow_valid(false),
+                                                                       m_full_pending(true),
+                                                                       m_fast_partial(false),
+                                                                       m_max_partial(REFRESH_MAX_PARTIAL),
+                                                                       m_area_budget(REFRESH_AREA_BUDGET)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/**
+ *  @brief: partial refreshes allowed between full ones, 0 for no limit
+ */
+void RefreshPolicy::SetMaxPartial(int count)
+{
+    m_max_partial = count;
+}
+
+/**
+ *  @brief: changed pixels allowed between full refreshes, 0 for no limit
+ */
+void RefreshPolicy::SetAreaBudget(long pixels)
+{
+    m_area_budget = pixels;
+}
+
+/**
+ *  @brief: use the fast partial waveform (Epd::PartInit), loaded
+ *          again after every full refresh
+ */
+void RefreshPolicy::SetFastPartial(bool fast)
+{
+    m_fast_partial = fast;
+    if (fast && !m_full_pending)
+    {
+        m_epd.PartInit();
+    }
+}
+
+/**
+ *  @brief: make the next update a full refresh
+ */
+void RefreshPolicy::ForceFull(void)
+{
+    m_full_pending = true;
+}
+
+/**
+ *  @brief: show a frame buffer. the changed area comes from the shadow
+ *          buffer, or is the whole frame without one.
+ *          returns REFRESH_NONE, REFRESH_PARTIAL or REFRESH_FULL, or
+ *          the negative EPD_ERROR_* of a failed refresh, which leaves
+ *          the budget and shadow buffer as they were.
+ */
+int RefreshPolicy::Update(const unsigned char *frame_buffer)
+{
+    long area = (long)EPD_WIDTH * EPD_HEIGHT;
+
+    if (m_shadow != NULL && m_shadow_valid)
+    {
+        area = CountChanges(frame_buffer);
+    }
+    return Refresh(frame_buffer, area, 0, 0, m_epd.width - 1, m_epd.height - 1);
+}
+
+/**
+ *  @brief: show a frame buffer of which only x0, y0 - x1, y1 changed,
+ *          inclusive, in the rotated coordinates of the drawing
+ *          functions. a partial refresh only uploads that area.
+ */
+int RefreshPolicy::Update(const unsigned char *frame_buffer, int x0, int y0, int x1, int y1)
+{
+    long area = (long)(x1 - x0 + 1) * (y1 - y0 + 1);
+
+    if (m_shadow != NULL && m_shadow_valid)
+    {
+        area = CountChanges(frame_buffer);
+    }
+    return Refresh(frame_buffer, area, x0, y0, x1, y1);
+}
+
+const RefreshStats &RefreshPolicy::GetStats(void)
+{
+    return m_stats;
+}
+
+/**
+ *  @brief: zero the counters, but not the budget already used
+ */
+void RefreshPolicy::ResetStats(void)
+{
+    int partial_since_full = m_stats.partial_since_full;
+    long area_since_full = m_stats.area_since_full;
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    /* the ghosting is still on the panel */
+    m_stats.partial_since_full = partial_since_full;
+    m_stats.area_since_full = area_since_full;
+}
+
+/**
+ *  @brief: private function for a full refresh, which also sets the base image partial
+ *          refreshes compare with
+ */
+int RefreshPolicy::RefreshFull(const unsigned char *frame_buffer)
+{
+    int result = m_epd.DisplayPartBaseImage(frame_buffer);
+    if (result == EPD_OK && m_fast_partial)
+    {
+        result = m_epd.PartInit();
+    }
+    return result;
+}
+
+/**
+ *  @brief: private function for a partial refresh
+ */
+int RefreshPolicy::RefreshPartial(const unsigned char *frame_buffer, int x0, int y0, int x1, int y1)
+{
+    if (x0 <= 0 && y0 <= 0 && x1 >= (int)m_epd.width - 1 && y1 >= (int)m_epd.height - 1)
+    {
+        return m_epd.DisplayPart(frame_buffer);
+    }
+    return m_epd.DisplayPartArea(frame_buffer, x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+/**
+ *  @brief: private function to pick and run the refresh
+ */
+int RefreshPolicy::Refresh(const unsigned char *frame_buffer, long area, int x0, int y0, int x1, int y1)
+{
+    int result;
+
+    if (area == 0 && !m_full_pending)
+    {
+        m_stats.skipped++;
+        return REFRESH_NONE;
+    }
+
+    bool over_budget = (m_max_partial > 0 && m_stats.partial_since_full + 1 > m_max_partial) ||
+                       (m_area_budget > 0 && m_stats.area_since_full + area > m_area_budget);
+    bool full = m_full_pending || over_budget;
+    int error = full ? RefreshFull(frame_buffer) : RefreshPartial(frame_buffer, x0, y0, x1, y1);
+    if (error != EPD_OK)
+    {
+        /* the budget and shadow buffer stay, the next update retries.
+           after a recovery the panel shows the shadow buffer again */
+        if (error == EPD_RECOVERED)
+        {
+            m_full_pending = true;
+        }
+        return error;
+    }
+
+    if (full)
+    {
+        if (!m_full_pending)
+        {
+            m_stats.promoted++;
+        }
+        m_full_pending = false;
+        m_stats.full++;
+        m_stats.partial_since_full = 0;
+        m_stats.area_since_full = 0;
+        result = REFRESH_FULL;
+    }
+    else
+    {
+        m_stats.partial++;
+        m_stats.partial_since_full++;
+        m_stats.area_since_full += area;
+        result = REFRESH_PARTIAL;
+    }
+
+    if (m_shadow != NULL)
+    {
+        memcpy(m_shadow, frame_buffer, FRAME_SIZE);
+        if (!m_shadow_valid)
+        {
+            /* a copy of the panel, unlike the caller's buffer */
+            m_epd.SetRecoveryFrame(m_shadow);
+        }
+        m_shadow_valid = true;
+    }
+    return result;
+}
+
+/**
+ *  @brief: private function to count the pixels that differ from the
+ *          shadow buffer, 32 at a time
+ */
+long RefreshPolicy::CountChanges(const unsigned char *frame_buffer)
+{
+    long count = 0;
+
+    for (int i = 0; i < FRAME_SIZE; i += 4)
+    {
+        unsigned long v = 0;
+        for (int k = 0; k < 4 && i + k < FRAME_SIZE; k++)
+        {
+            v = (v << 8) | (unsigned char)(frame_buffer[i + k] ^ m_shadow[i + k]);
+        }
+        v = v - ((v >> 1) & 0x55555555UL);
+        v = (v & 0x33333333UL) + ((v >> 2) & 0x33333333UL);
+        v = (v + (v >> 4)) & 0x0F0F0F0FUL;
+        count += (v * 0x01010101UL & 0xFFFFFFFFUL) >> 24;
+    }
+    return count;
+}
@@ -0,0 +1,77 @@
+/**
+ *  @filename   :   refreshpolicy.h
+ *  @brief      :   Decides between a partial and a full refresh. Every
+ *                  partial refresh leaves a little ghosting behind, so
+ *                  the number of partial refreshes and the area they
+ *                  changed since the last full refresh are counted, and
+ *                  an update is promoted to a full refresh once either
+ *                  goes over its budget.
+ *
+ *                  With a shadow buffer (a copy of the frame buffer on
+ *                  the panel, EPD_WIDTH * EPD_HEIGHT / 8 bytes) the
+ *                  changed pixels are counted exactly and unchanged
+ *                  frames are skipped. Without one, the caller passes
+ *                  the changed area or the whole frame counts.
+ *                  The shadow buffer is also the frame Recover puts
+ *                  back once it holds a shown frame.
+ */
+
+#ifndef REFRESHPOLICY_H
+#define REFRESHPOLICY_H
+
+#include "epd1in54v2.h"
+
+// What Update did, or a negative EPD_ERROR_*
+#define REFRESH_NONE 0
+#define REFRESH_PARTIAL 1
+#define REFRESH_FULL 2
+
+// Default budgets between full refreshes
+#define REFRESH_MAX_PARTIAL 20
+#define REFRESH_AREA_BUDGET (2L * EPD_WIDTH * EPD_HEIGHT)
+
+struct RefreshStats
+{
+    unsigned long full;     /* full refreshes */
+    unsigned long partial;  /* partial refreshes */
+    unsigned long promoted; /* updates made full by the budget */
+    unsigned long skipped;  /* updates without changes */
+    int partial_since_full;
+    long area_since_full;   /* changed pixels */
+};
+
+class RefreshPolicy
+{
+public:
+    RefreshPolicy(Epd &epd, unsigned char *shadow_buffer);
+
+    void SetMaxPartial(int count);
+    void SetAreaBudget(long pixels);
+    void SetFastPartial(bool fast);
+    void ForceFull(void);
+
+    int Update(const unsigned char *frame_buffer);
+    int Update(const unsigned char *frame_buffer, int x0, int y0, int x1, int y1);
+
+    const RefreshStats &GetStats(void);
+    void ResetStats(void);
+
+private:
+    int RefreshFull(const unsigned char *frame_buffer);
+    int RefreshPartial(const unsigned char *frame_buffer, int x0, int y0, int x1, int y1);
+    int Refresh(const unsigned char *frame_buffer, long area, int x0, int y0, int x1, int y1);
+    long CountChanges(const unsigned char *frame_buffer);
+
+    Epd &m_epd;
+    unsigned char *m_shadow;
+    bool m_shadow_valid;
+    bool m_full_pending;
+    bool m_fast_partial;
+    int m_max_partial;
+    long m_area_budget;
+    RefreshStats m_stats;
+};
+
+#endif /* REFRESHPOLICY_H */
+
+/* END OF FILE */
@@ -0,0 +1,206 @@
+/**
+ *  @filename   :   sevensegment.cpp
+ *  @brief      :   Implements the seven segment readout
+ */
+
+#include "sevensegment.h"
+
+SevenSegment::SevenSegment(Epd &epd,
+                           int x,
+                           int y,
+                           int digits,
+                           int digit_width,
+                           int digit_height,
+                           int thickness) : m_epd(epd),
+                                            m_x(x),
+                                            m_y(y),
+                                            m_digits(digits > SEGMENT_MAX_DIGITS ? SEGMENT_MAX_DIGITS : digits),
+                                            m_width(digit_width),
+                                            m_height(digit_height),
+                                            m_thickness(thickness)
+{
+    Invalidate();
+}
+
+/**
+ *  @brief: segments of a charactor, 0 for the ones that can't be shown
+ */
+unsigned char SevenSegment::Encode(char c)
+{
+    static const unsigned char digits[16] = {
+        0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,
+        0x7F, 0x6F, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71};
+
+    if (c >= '0' && c <= '9')
+    {
+        return digits[c - '0'];
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return digits[c - 'A' + 10];
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return digits[c - 'a' + 10];
+    }
+    switch (c)
+    {
+    case '-':
+        return SEGMENT_G;
+    case '_':
+        return SEGMENT_D;
+    case 'H':
+        return SEGMENT_B | SEGMENT_C | SEGMENT_E | SEGMENT_F | SEGMENT_G;
+    case 'L':
+        return SEGMENT_D | SEGMENT_E | SEGMENT_F;
+    case 'P':
+        return SEGMENT_A | SEGMENT_B | SEGMENT_E | SEGMENT_F | SEGMENT_G;
+    case 'o':
+        return SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_G;
+    case 'r':
+        return SEGMENT_E | SEGMENT_G;
+    default:
+        return 0;
+    }
+}
+
+/**
+ *  @brief: forget the drawn segments, the next Draw paints all of them.
+ *          call this after the frame buffer was cleared or drawn over.
+ */
+void SevenSegment::Invalidate(void)
+{
+    m_valid = false;
+    for (int i = 0; i < SEGMENT_MAX_DIGITS; i++)
+    {
+        m_state[i] = 0;
+    }
+    m_dirty_x0 = m_dirty_y0 = 1;
+    m_dirty_x1 = m_dirty_y1 = 0;
+}
+
+/**
+ *  @brief: width of the readout, each digit is followed by room
+ *          for its decimal point
+ */
+int SevenSegment::GetWidth(void)
+{
+    return m_digits * (m_width + 2 * m_thickness);
+}
+
+/**
+ *  @brief: draw a value, left aligned. a '.' lights the decimal point
+ *          of the digit before it. only changed segments are painted,
+ *          returns true if any were.
+ */
+bool SevenSegment::Draw(unsigned char *frame_buffer, const char *value, int colored)
+{
+    unsigned char next[SEGMENT_MAX_DIGITS] = {0};
+    int digit = 0;
+
+    for (const char *p = value; *p != 0; p++)
+    {
+        if (*p == '.' && digit > 0 && !(next[digit - 1] & SEGMENT_DP))
+        {
+            next[digit - 1] |= SEGMENT_DP;
+        }
+        else if (digit < m_digits)
+        {
+            next[digit++] = *p == '.' ? SEGMENT_DP : Encode(*p);
+        }
+    }
+
+    m_dirty_x0 = m_dirty_y0 = 1;
+    m_dirty_x1 = m_dirty_y1 = 0;
+    for (int i = 0; i < m_digits; i++)
+    {
+        unsigned char changed = m_valid ? (unsigned char)(next[i] ^ m_state[i]) : 0xFF;
+        for (int segment = 0; segment < 8; segment++)
+        {
+            if (changed & (1 << segment))
+            {
+                DrawSegment(frame_buffer, i, segment, (next[i] & (1 << segment)) ? colored : !colored);
+            }
+        }
+        m_state[i] = next[i];
+    }
+    m_valid = true;
+    return m_dirty_x0 <= m_dirty_x1;
+}
+
+/**
+ *  @brief: bounding box of the segments painted by the last Draw,
+ *          returns false if nothing changed
+ */
+bool SevenSegment::GetDirtyArea(int *x0, int *y0, int *x1, int *y1)
+{
+    if (m_dirty_x0 > m_dirty_x1)
+    {
+        return false;
+    }
+    *x0 = m_dirty_x0;
+    *y0 = m_dirty_y0;
+    *x1 = m_dirty_x1;
+    *y1 = m_dirty_y1;
+    return true;
+}
+
+void SevenSegment::DrawSegment(unsigned char *frame_buffer, int digit, int segment, int colored)
+{
+    int t = m_thickness;
+    int w = m_width;
+    int h = m_height;
+    int mid = h / 2;
+    int x = m_x + digit * (w + 2 * t);
+    int y = m_y;
+    int x0, y0, x1, y1;
+
+    switch (1 << segment)
+    {
+    case SEGMENT_A:
+        x0 = t, y0 = 0, x1 = w - t - 1, y1 = t - 1;
+        break;
+    case SEGMENT_B:
+        x0 = w - t, y0 = t, x1 = w - 1, y1 = mid - 1;
+        break;
+    case SEGMENT_C:
+        x0 = w - t, y0 = mid, x1 = w - 1, y1 = h - t - 1;
+        break;
+    case SEGMENT_D:
+        x0 = t, y0 = h - t, x1 = w - t - 1, y1 = h - 1;
+        break;
+    case SEGMENT_E:
+        x0 = 0, y0 = mid, x1 = t - 1, y1 = h - t - 1;
+        break;
+    case SEGMENT_F:
+        x0 = 0, y0 = t, x1 = t - 1, y1 = mid - 1;
+        break;
+    case SEGMENT_G:
+        x0 = t, y0 = mid - t / 2, x1 = w - t - 1, y1 = mid - t / 2 + t - 1;
+        break;
+    default: /* SEGMENT_DP */
+        x0 = w + t / 2, y0 = h - t, x1 = w + t / 2 + t - 1, y1 = h - 1;
+        break;
+    }
+
+    x0 += x;
+    x1 += x;
+    y0 += y;
+    y1 += y;
+    m_epd.DrawFilledRectangle(frame_buffer, x0, y0, x1, y1, colored);
+
+    if (m_dirty_x0 > m_dirty_x1)
+    {
+        m_dirty_x0 = x0;
+        m_dirty_y0 = y0;
+        m_dirty_x1 = x1;
+        m_dirty_y1 = y1;
+    }
+    else
+    {
+        m_dirty_x0 = x0 < m_dirty_x0 ? x0 : m_dirty_x0;
+        m_dirty_y0 = y0 < m_dirty_y0 ? y0 : m_dirty_y0;
+        m_dirty_x1 = x1 > m_dirty_x1 ? x1 : m_dirty_x1;
+        m_dirty_y1 = y1 > m_dirty_y1 ? y1 : m_dirty_y1;
+    }
+}
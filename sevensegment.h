@@ -0,0 +1,65 @@
+/**
+ *  @filename   :   sevensegment.h
+ *  @brief      :   Large seven segment readouts drawn with rectangle fills.
+ *                  The segment states of the last drawn value are kept,
+ *                  so a new value only repaints the segments that turned
+ *                  on or off, and the area they cover can be handed to a
+ *                  partial refresh.
+ */
+
+#ifndef SEVENSEGMENT_H
+#define SEVENSEGMENT_H
+
+#include "epd1in54v2.h"
+
+#define SEGMENT_MAX_DIGITS 8
+
+// Segment bits, a is the top segment, clockwise to f, g in the middle
+#define SEGMENT_A 0x01
+#define SEGMENT_B 0x02
+#define SEGMENT_C 0x04
+#define SEGMENT_D 0x08
+#define SEGMENT_E 0x10
+#define SEGMENT_F 0x20
+#define SEGMENT_G 0x40
+#define SEGMENT_DP 0x80
+
+class SevenSegment
+{
+public:
+    SevenSegment(Epd &epd,
+                 int x,
+                 int y,
+                 int digits,
+                 int digit_width,
+                 int digit_height,
+                 int thickness);
+
+    bool Draw(unsigned char *frame_buffer, const char *value, int colored);
+    void Invalidate(void);
+    bool GetDirtyArea(int *x0, int *y0, int *x1, int *y1);
+    int GetWidth(void);
+
+    static unsigned char Encode(char c);
+
+private:
+    void DrawSegment(unsigned char *frame_buffer, int digit, int segment, int colored);
+
+    Epd &m_epd;
+    int m_x;
+    int m_y;
+    int m_digits;
+    int m_width;
+    int m_height;
+    int m_thickness;
+    bool m_valid;
+    unsigned char m_state[SEGMENT_MAX_DIGITS];
+    int m_dirty_x0;
+    int m_dirty_y0;
+    int m_dirty_x1;
+    int m_dirty_y1;
+};
+
+#endif /* SEVENSEGMENT_H */
+
+/* END OF FILE */
@@ -0,0 +1,150 @@
+/**
+ *  @filename   :   textcache.cpp
+ *  @brief      :   Implements the rendered string cache
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "textcache.h"
+
+TextCache::TextCache(size_t budget) : hits(0),
+                                      misses(0),
+                                      m_head(NULL),
+                                      m_tail(NULL),
+                                      m_budget(budget),
+                                      m_used(0)
+{
+}
+
+TextCache::~TextCache()
+{
+    Clear();
+}
+
+/**
+ *  @brief: drop all entries
+ */
+void TextCache::Clear(void)
+{
+    while (m_head != NULL)
+    {
+        Entry *entry = m_head;
+        Unlink(entry);
+        free(entry);
+    }
+    m_used = 0;
+}
+
+size_t TextCache::Budget(void) const
+{
+    return m_budget;
+}
+
+size_t TextCache::Used(void) const
+{
+    return m_used;
+}
+
+/**
+ *  @brief: look up a string, a hit becomes the most recently used entry
+ */
+TextCache::Entry *TextCache::Find(const char *text, unsigned int length, const sFONT *font, unsigned int rotate)
+{
+    for (Entry *entry = m_head; entry != NULL; entry = entry->next)
+    {
+        if (entry->font == font &&
+            entry->rotate == rotate &&
+            entry->length == length &&
+            memcmp(entry->text, text, length) == 0)
+        {
+            if (entry != m_head)
+            {
+                Unlink(entry);
+                PushFront(entry);
+            }
+            hits++;
+            return entry;
+        }
+    }
+    misses++;
+    return NULL;
+}
+
+/**
+ *  @brief: add a cleared width x height mask for a string,
+ *          evicting old entries to stay within the budget.
+ *          returns NULL if the string alone exceeds the budget.
+ */
+TextCache::Entry *TextCache::Insert(const char *text, unsigned int length, const sFONT *font, unsigned int rotate,
+                                    int width, int height)
+{
+    size_t bits_size = (size_t)((width + 7) / 8) * height;
+    size_t size = sizeof(Entry) + length + bits_size;
+
+    if (size > m_budget)
+    {
+        return NULL;
+    }
+    while (m_used + size > m_budget && m_tail != NULL)
+    {
+        Entry *victim = m_tail;
+        Unlink(victim);
+        m_used -= victim->size;
+        free(victim);
+    }
+
+    Entry *entry = (Entry *)malloc(size);
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+    entry->font = font;
+    entry->rotate = rotate;
+    entry->length = length;
+    entry->width = width;
+    entry->height = height;
+    entry->size = size;
+    entry->bits = (unsigned char *)(entry + 1);
+    entry->text = (char *)(entry->bits + bits_size);
+    memcpy(entry->text, text, length);
+    memset(entry->bits, 0, bits_size);
+
+    PushFront(entry);
+    m_used += size;
+    return entry;
+}
+
+void TextCache::Unlink(Entry *entry)
+{
+    if (entry->prev != NULL)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        m_head = entry->next;
+    }
+    if (entry->next != NULL)
+    {
+        entry->next->prev = entry->prev;
+    }
+    else
+    {
+        m_tail = entry->prev;
+    }
+}
+
+void TextCache::PushFront(Entry *entry)
+{
+    entry->prev = NULL;
+    entry->next = m_head;
+    if (m_head != NULL)
+    {
+        m_head->prev = entry;
+    }
+    else
+    {
+        m_tail = entry;
+    }
+    m_head = entry;
+}
@@ -0,0 +1,66 @@
+/**
+ *  @filename   :   textcache.h
+ *  @brief      :   Cache of rendered strings for Epd::DrawStringAt.
+ *                  Each entry holds the glyph mask of one string for one
+ *                  font and rotation, already laid out in frame buffer
+ *                  orientation, so a cached label is drawn with a few
+ *                  byte operations per row instead of decoding its glyphs.
+ *                  Entries are evicted least recently used first once
+ *                  the byte budget is exceeded.
+ */
+
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include <stddef.h>
+#include "fonts.h"
+
+class TextCache
+{
+public:
+    TextCache(size_t budget);
+    ~TextCache();
+
+    void Clear(void);
+    size_t Budget(void) const;
+    size_t Used(void) const;
+
+    unsigned long hits;
+    unsigned long misses;
+
+private:
+    friend class Epd;
+
+    struct Entry
+    {
+        Entry *prev;
+        Entry *next;
+        const sFONT *font;
+        unsigned int rotate;
+        unsigned int length;
+        int width;
+        int height;
+        size_t size;
+        char *text;
+        unsigned char *bits;
+    };
+
+    Entry *Find(const char *text, unsigned int length, const sFONT *font, unsigned int rotate);
+    Entry *Insert(const char *text, unsigned int length, const sFONT *font, unsigned int rotate,
+                  int width, int height);
+    void Unlink(Entry *entry);
+    void PushFront(Entry *entry);
+
+    /* no copies, the cache owns its entries */
+    TextCache(const TextCache &);
+    TextCache &operator=(const TextCache &);
+
+    Entry *m_head;
+    Entry *m_tail;
+    size_t m_budget;
+    size_t m_used;
+};
+
+#endif /* TEXTCACHE_H */
+
+/* END OF FILE */
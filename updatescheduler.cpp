@@ -0,0 +1,145 @@
+/**
+ *  @filename   :   updatescheduler.cpp
+ *  @brief      :   Implements the update scheduler
+ */
+
+#include "updatescheduler.h"
+
+UpdateScheduler::UpdateScheduler(Epd &epd, RefreshPolicy &policy, const unsigned char *frame_buffer) : marked(0),
+                                                                                                      refreshes(0),
+                                                                                                      m_epd(epd),
+                                                                                                      m_policy(policy),
+                                                                                                      m_frame_buffer(frame_buffer),
+                                                                                                      m_interval(UPDATE_INTERVAL),
+                                                                                                      m_last_ms(0),
+                                                                                                      m_refreshed(false),
+                                                                                                      m_x0(1),
+                                                                                                      m_y0(1),
+                                                                                                      m_x1(0),
+                                                                                                      m_y1(0)
+{
+}
+
+/**
+ *  @brief: minimum ms from one refresh to the next
+ */
+void UpdateScheduler::SetInterval(unsigned long interval_ms)
+{
+    m_interval = interval_ms;
+}
+
+/**
+ *  @brief: x0, y0 - x1, y1 changed, inclusive, in the rotated
+ *          coordinates of the drawing functions
+ */
+void UpdateScheduler::MarkDirty(int x0, int y0, int x1, int y1)
+{
+    marked++;
+    Merge(x0, y0, x1, y1);
+}
+
+void UpdateScheduler::MarkAllDirty(void)
+{
+    MarkDirty(0, 0, m_epd.width - 1, m_epd.height - 1);
+}
+
+bool UpdateScheduler::IsDirty(void)
+{
+    return m_x0 <= m_x1;
+}
+
+/**
+ *  @brief: private function to grow the dirty area by x0, y0 - x1, y1
+ */
+void UpdateScheduler::Merge(int x0, int y0, int x1, int y1)
+{
+    if (x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+    if (m_x0 > m_x1)
+    {
+        m_x0 = x0;
+        m_y0 = y0;
+        m_x1 = x1;
+        m_y1 = y1;
+        return;
+    }
+    if (x0 < m_x0)
+    {
+        m_x0 = x0;
+    }
+    if (y0 < m_y0)
+    {
+        m_y0 = y0;
+    }
+    if (x1 > m_x1)
+    {
+        m_x1 = x1;
+    }
+    if (y1 > m_y1)
+    {
+        m_y1 = y1;
+    }
+}
+
+/**
+ *  @brief: ms until Poll will refresh, 0 if it would now. nothing
+ *          dirty waits a whole interval.
+ */
+unsigned long UpdateScheduler::GetWait(void)
+{
+    unsigned long elapsed = m_epd.GetMs() - m_last_ms;
+
+    if (!m_refreshed || elapsed >= m_interval)
+    {
+        return IsDirty() ? 0 : m_interval;
+    }
+    return m_interval - elapsed;
+}
+
+/**
+ *  @brief: refresh the dirty area if the interval is over.
+ *          returns REFRESH_NONE if nothing was done, else what the
+ *          refresh policy did. a failed refresh keeps the area dirty
+ *          for the next interval.
+ */
+int UpdateScheduler::Poll(void)
+{
+    if (!IsDirty() || GetWait() > 0)
+    {
+        return REFRESH_NONE;
+    }
+    return Flush();
+}
+
+/**
+ *  @brief: refresh the dirty area now, ignoring the interval
+ */
+int UpdateScheduler::Flush(void)
+{
+    if (!IsDirty())
+    {
+        return REFRESH_NONE;
+    }
+    int x0 = m_x0;
+    int y0 = m_y0;
+    int x1 = m_x1;
+    int y1 = m_y1;
+
+    /* changes made during the refresh mark the area again */
+    m_x0 = 1;
+    m_x1 = 0;
+    int result = m_policy.Update(m_frame_buffer, x0, y0, x1, y1);
+    m_last_ms = m_epd.GetMs();
+    m_refreshed = true;
+    if (result < 0)
+    {
+        Merge(x0, y0, x1, y1);
+    }
+    else if (result != REFRESH_NONE)
+    {
+        refreshes++;
+    }
+    return result;
+}
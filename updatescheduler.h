@@ -0,0 +1,59 @@
+/**
+ *  @filename   :   updatescheduler.h
+ *  @brief      :   Collects the areas changed in a frame buffer and
+ *                  refreshes them together, at most once per interval.
+ *                  Changes that come in bursts then cost one refresh
+ *                  instead of one each. The frame buffer is read when
+ *                  the refresh happens, so the newest content is shown.
+ *                  Refreshes go through a RefreshPolicy.
+ *
+ *                  epd.DrawStringAt(frame_buffer, ...);
+ *                  scheduler.MarkDirty(x0, y0, x1, y1);
+ *                  ...
+ *                  scheduler.Poll(); // from the main loop
+ */
+
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include "epd1in54v2.h"
+#include "refreshpolicy.h"
+
+// Default minimum ms between refreshes
+#define UPDATE_INTERVAL 500
+
+class UpdateScheduler
+{
+public:
+    UpdateScheduler(Epd &epd, RefreshPolicy &policy, const unsigned char *frame_buffer);
+
+    void SetInterval(unsigned long interval_ms);
+    void MarkDirty(int x0, int y0, int x1, int y1);
+    void MarkAllDirty(void);
+    bool IsDirty(void);
+    unsigned long GetWait(void);
+    int Poll(void);
+    int Flush(void);
+
+    unsigned long marked;    /* MarkDirty calls */
+    unsigned long refreshes; /* refreshes issued for them */
+
+private:
+    void Merge(int x0, int y0, int x1, int y1);
+
+    Epd &m_epd;
+    RefreshPolicy &m_policy;
+    const unsigned char *m_frame_buffer;
+    unsigned long m_interval;
+    unsigned long m_last_ms;
+    bool m_refreshed;
+    /* merged dirty area, empty while x0 > x1 */
+    int m_x0;
+    int m_y0;
+    int m_x1;
+    int m_y1;
+};
+
+#endif /* UPDATESCHEDULER_H */
+
+/* END OF FILE */